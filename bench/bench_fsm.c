@@ -0,0 +1,92 @@
+/*
+ * MultiButton State Machine Benchmark
+ * Measures the state machine engine selected at build time (switch, or
+ * table with MULTIBUTTON_FSM_TABLE) on a pool of busy buttons. The event
+ * checksum must be identical for both engines.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "multi_button.h"
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLES() __rdtsc()
+#else
+#define BENCH_CYCLES() 0ULL
+#endif
+
+#define NUM_BUTTONS   256
+#define BENCH_TICKS   20000
+
+#ifdef MULTIBUTTON_FSM_TABLE
+#define ENGINE_NAME   "table"
+#else
+#define ENGINE_NAME   "switch"
+#endif
+
+// Simulated input levels, one per slot
+static volatile uint8_t levels[NUM_BUTTONS];
+static uint32_t checksum = 0;
+
+BUTTON_POOL_DEFINE(pool, NUM_BUTTONS);
+
+static uint8_t read_pool(uint16_t index)
+{
+    return levels[index];
+}
+
+static void on_event(ButtonPool* p, uint16_t index, void* user_data)
+{
+    (void)user_data;
+    checksum = checksum * 31U + (uint32_t)(index << 4) + (uint32_t)button_pool_get_event(p, index);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Mix of clicks, double clicks and long presses: each slot toggles with its own period
+static void stimulate(int t)
+{
+    for (int i = 0; i < NUM_BUTTONS; i++) {
+        int period = 8 + (i % 29) * 9;
+        if (t % period == 0) {
+            levels[i] ^= 1U;
+        }
+    }
+}
+
+int main(void)
+{
+    button_pool_init(&pool, read_pool);
+    for (int i = 0; i < NUM_BUTTONS; i++) {
+        button_pool_add(&pool, 1);
+        for (int ev = 0; ev < BTN_EVENT_COUNT; ev++) {
+            button_pool_attach(&pool, (uint16_t)i, (ButtonEvent)ev, on_event, NULL);
+        }
+    }
+
+    double total_ns = 0;
+    unsigned long long total_cycles = 0;
+    for (int t = 0; t < BENCH_TICKS; t++) {
+        stimulate(t);
+        double t0 = now_ns();
+        unsigned long long c0 = BENCH_CYCLES();
+        button_pool_ticks(&pool);
+        total_cycles += BENCH_CYCLES() - c0;
+        total_ns += now_ns() - t0;
+    }
+
+    printf("MultiButton state machine benchmark: %d buttons, %d ticks\n", NUM_BUTTONS, BENCH_TICKS);
+    printf("%-8s %8.2f ns/button/tick  %8.2f cycles/button/tick  checksum %08lx\n", ENGINE_NAME,
+           total_ns / ((double)BENCH_TICKS * NUM_BUTTONS),
+           (double)total_cycles / ((double)BENCH_TICKS * NUM_BUTTONS),
+           (unsigned long)checksum);
+    return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * MultiButton Pool Benchmark
+ * Compares the intrusive linked list against ButtonPool parallel arrays
+ * for a large number of simulated buttons.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "multi_button.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define NUM_BUTTONS   4096
+#define BENCH_TICKS   2000
+
+// Simulated input levels, indexed by button id (list) or slot (pool)
+static volatile uint8_t levels[256];
+
+BUTTON_POOL_DEFINE(pool, NUM_BUTTONS);
+
+static uint8_t read_list(uint8_t button_id)
+{
+    return levels[button_id];
+}
+
+static uint8_t read_pool(uint16_t index)
+{
+    return levels[index & 0xFF];
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void stimulate(int t)
+{
+    // Press and release a few inputs so some buttons leave idle
+    if ((t & 31) == 0) {
+        levels[(t >> 5) & 0xFF] ^= 1U;
+    }
+}
+
+int main(void)
+{
+    // Scatter list nodes over the heap in shuffled order, like buttons
+    // embedded in unrelated application structs
+    Button** nodes = malloc(NUM_BUTTONS * sizeof(Button*));
+    for (int i = 0; i < NUM_BUTTONS; i++) {
+        nodes[i] = malloc(sizeof(Button) + 64 + (size_t)(rand() % 512));
+    }
+    for (int i = NUM_BUTTONS - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        Button* tmp = nodes[i];
+        nodes[i] = nodes[j];
+        nodes[j] = tmp;
+    }
+    for (int i = 0; i < NUM_BUTTONS; i++) {
+        button_init(nodes[i], read_list, 1, (uint8_t)i);
+        button_start(nodes[i]);
+    }
+
+    button_pool_init(&pool, read_pool);
+    for (int i = 0; i < NUM_BUTTONS; i++) {
+        button_pool_add(&pool, 1);
+    }
+
+    printf("MultiButton pool benchmark: %d buttons, %d ticks\n", NUM_BUTTONS, BENCH_TICKS);
+
+    double t0 = now_ns();
+    for (int t = 0; t < BENCH_TICKS; t++) {
+        stimulate(t);
+        button_ticks();
+    }
+    double t1 = now_ns();
+    printf("linked list  %8.2f ns/button/tick\n", (t1 - t0) / BENCH_TICKS / NUM_BUTTONS);
+
+    for (int i = 0; i < 256; i++) {
+        levels[i] = 0;
+    }
+
+    t0 = now_ns();
+    for (int t = 0; t < BENCH_TICKS; t++) {
+        stimulate(t);
+        button_pool_ticks(&pool);
+    }
+    t1 = now_ns();
+    printf("button pool  %8.2f ns/button/tick\n", (t1 - t0) / BENCH_TICKS / NUM_BUTTONS);
+
+    for (int i = 0; i < NUM_BUTTONS; i++) {
+        button_stop(nodes[i]);
+        free(nodes[i]);
+    }
+    free(nodes);
+    return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * MultiButton Port Read Benchmark
+ * Compares per-button HAL reads against port-mapped reads for 24 buttons
+ * spread over two 32-bit GPIO ports. Counts read callbacks and register
+ * accesses per tick, and models the wait states of a peripheral bus so the
+ * saving per avoided access shows up in the timings.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "multi_button.h"
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLES() __rdtsc()
+#else
+#define BENCH_CYCLES() 0ULL
+#endif
+
+#define NUM_BUTTONS   24
+#define BENCH_TICKS   200000
+
+// Bus wait states of a slow GPIO peripheral, modelled as extra volatile loads per access
+#ifndef BENCH_BUS_WAIT
+#define BENCH_BUS_WAIT 20
+#endif
+
+// Simulated GPIO input registers, volatile so every read hits "hardware"
+static volatile uint32_t gpio_port[2];
+static volatile uint32_t bus_stall;
+static int bus_wait;
+
+static Button buttons[NUM_BUTTONS];
+static unsigned long hal_calls;     // read callbacks invoked by the library
+static unsigned long reg_reads;     // GPIO register accesses
+
+static uint32_t gpio_read(uint8_t port)
+{
+    for (int w = 0; w < bus_wait; w++) {
+        (void)bus_stall;
+    }
+    reg_reads++;
+    return gpio_port[port];
+}
+
+static uint8_t read_pin(uint8_t button_id)
+{
+    hal_calls++;
+    return (gpio_read(button_id / 12) >> (button_id % 12)) & 1U;
+}
+
+static uint32_t read_port(uint8_t port)
+{
+    hal_calls++;
+    return gpio_read(port);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static double run(const char* name, int port_mapped, int wait)
+{
+    for (int i = 0; i < NUM_BUTTONS; i++) {
+        if (port_mapped) {
+            button_init_port(&buttons[i], (uint8_t)(i / 12), 1UL << (i % 12), 1, (uint8_t)i);
+        } else {
+            button_init(&buttons[i], read_pin, 1, (uint8_t)i);
+        }
+        button_start(&buttons[i]);
+    }
+    gpio_port[0] = gpio_port[1] = 0;
+    bus_wait = wait;
+    hal_calls = 0;
+    reg_reads = 0;
+
+    double t0 = now_ns();
+    unsigned long long c0 = BENCH_CYCLES();
+    for (int t = 0; t < BENCH_TICKS; t++) {
+        // Toggle one input every 64 ticks to keep the state machines busy
+        if ((t & 63) == 0) {
+            gpio_port[(t >> 6) & 1] ^= 1UL << ((t >> 7) % 12);
+        }
+        button_ticks();
+    }
+    unsigned long long c1 = BENCH_CYCLES();
+    double t1 = now_ns();
+
+    double ns = (t1 - t0) / BENCH_TICKS;
+    printf("  %-12s %5.1f calls/tick  %5.1f reads/tick  %8.1f ns/tick  %8.1f cycles/tick\n", name,
+           (double)hal_calls / BENCH_TICKS, (double)reg_reads / BENCH_TICKS,
+           ns, (double)(c1 - c0) / BENCH_TICKS);
+
+    for (int i = 0; i < NUM_BUTTONS; i++) {
+        button_stop(&buttons[i]);
+    }
+    return ns;
+}
+
+int main(void)
+{
+    printf("MultiButton port read benchmark: %d buttons, 2 ports, %d ticks\n",
+           NUM_BUTTONS, BENCH_TICKS);
+
+    button_port_init(read_port);
+    for (int wait = 0; wait <= BENCH_BUS_WAIT; wait += BENCH_BUS_WAIT) {
+        printf("%d wait states per register read:\n", wait);
+        double pin_ns = run("per-pin HAL", 0, wait);
+        double port_ns = run("port-mapped", 1, wait);
+        printf("  saving       %8.1f ns/tick (%.0f%%)\n", pin_ns - port_ns,
+               100.0 * (pin_ns - port_ns) / pin_ns);
+    }
+    return 0;
+}
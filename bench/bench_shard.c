@@ -0,0 +1,106 @@
+/*
+ * MultiButton Sharded Ticking Benchmark
+ * Ticks a large simulated button population split over 1 to N worker
+ * threads and reports the time per tick and the speedup over one shard.
+ * Usage: bench_shard [max_threads]   (default: online CPUs)
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include "multi_button_shard.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NUM_BUTTONS   61440
+#define BENCH_TICKS   500
+#define MAX_SHARDS    64
+
+static int sim_tick = 0;
+static uint32_t shard_base[MAX_SHARDS];
+static uint32_t total_events = 0;
+
+// Each button toggles with its own period, so the state machines stay busy
+static uint8_t read_level(uint16_t index)
+{
+    uint32_t global = shard_base[button_shard_current()] + index;
+    uint32_t period = 3 + (global * 2654435761U >> 24) % 120;
+    return (uint8_t)(((uint32_t)sim_tick + global) / period & 1U);
+}
+
+static void count_events(const ButtonShardEvent* events, uint32_t count, void* user_data)
+{
+    (void)events;
+    (void)user_data;
+    total_events += count;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static double run(int threads)
+{
+    static ButtonPool pools[MAX_SHARDS];
+    static ButtonShard shards[MAX_SHARDS];
+    ButtonShards group;
+    uint32_t per_shard = (NUM_BUTTONS + threads - 1) / threads;
+
+    for (int s = 0; s < threads; s++) {
+        uint32_t first = (uint32_t)s * per_shard;
+        uint32_t slots = (first + per_shard <= NUM_BUTTONS) ? per_shard : NUM_BUTTONS - first;
+
+        shard_base[s] = first;
+        button_shard_pool_create(&pools[s], (uint16_t)slots);
+        button_pool_init(&pools[s], read_level);
+        for (uint32_t i = 0; i < slots; i++) {
+            button_pool_add(&pools[s], 1);
+        }
+        shards[s].pool = &pools[s];
+    }
+    if (button_shards_init(&group, shards, (uint16_t)threads, count_events, NULL) != 0) {
+        fprintf(stderr, "failed to start %d shards\n", threads);
+        exit(1);
+    }
+
+    total_events = 0;
+    double t0 = now_ns();
+    for (sim_tick = 0; sim_tick < BENCH_TICKS; sim_tick++) {
+        button_shards_tick(&group);
+    }
+    double t1 = now_ns();
+
+    button_shards_destroy(&group);
+    for (int s = 0; s < threads; s++) {
+        button_shard_pool_destroy(&pools[s]);
+    }
+    return (t1 - t0) / BENCH_TICKS;
+}
+
+int main(int argc, char** argv)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = (argc > 1) ? atoi(argv[1]) : (int)(cpus > 0 ? cpus : 1);
+
+    if (max_threads < 1) max_threads = 1;
+    if (max_threads > MAX_SHARDS) max_threads = MAX_SHARDS;
+
+    printf("MultiButton shard benchmark: %d buttons, %d ticks, %ld online CPUs\n",
+           NUM_BUTTONS, BENCH_TICKS, cpus);
+
+    // Powers of two, then max_threads
+    double base = 0;
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > max_threads) threads = max_threads;
+        double ns = run(threads);
+        if (threads == 1) base = ns;
+        printf("%3d threads  %10.1f us/tick  %6.2f ns/button/tick  speedup %5.2fx  (%u events)\n",
+               threads, ns / 1000.0, ns / NUM_BUTTONS, base / ns, total_events);
+        if (threads == max_threads) break;
+    }
+    return 0;
+}
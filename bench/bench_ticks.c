@@ -0,0 +1,153 @@
+/*
+ * MultiButton Tick Hot Path Benchmark
+ * Measures ns per button per button_ticks() call for 1 to 100k list
+ * buttons under idle, bouncing and active inputs, with and without
+ * callbacks attached. Results are written as JSON for regression tracking.
+ * Usage: bench_ticks [output.json]   (default: stdout)
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "multi_button.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define PATTERN_LEN      1024           // input pattern period in ticks (power of 2)
+#define WORK_PER_RUN     4000000UL      // button ticks per measurement
+#define MIN_TICKS        PATTERN_LEN     // at least one full input pattern
+
+typedef enum {
+    WORKLOAD_IDLE = 0,      // inputs never change
+    WORKLOAD_BOUNCE,        // inputs chatter every tick and never settle
+    WORKLOAD_ACTIVE,        // clicks, double clicks and long holds
+    WORKLOAD_COUNT
+} Workload;
+
+static const char* const workload_names[WORKLOAD_COUNT] = { "idle", "bounce", "active" };
+static const uint32_t button_counts[] = { 1, 8, 64, 1000, 100000 };
+
+// Input level per pattern tick for each workload, phase shifted per button id
+static uint8_t pattern[WORKLOAD_COUNT][PATTERN_LEN];
+static uint16_t phase[256];
+static const uint8_t* current_pattern;
+static uint32_t bench_tick = 0;
+static uint32_t events = 0;
+
+static uint8_t read_level(uint8_t button_id)
+{
+    return current_pattern[(bench_tick + phase[button_id]) & (PATTERN_LEN - 1)];
+}
+
+static void count_event(Button* btn, void* user_data)
+{
+    (void)btn;
+    (void)user_data;
+    events++;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void press(uint8_t* p, int from, int to)
+{
+    for (int t = from; t < to; t++) {
+        p[t] = 1;
+    }
+}
+
+static void build_patterns(void)
+{
+    uint32_t seed = 12345;
+
+    // Random chatter: pressed runs stay shorter than the debounce window
+    for (int t = 0, run = 0; t < PATTERN_LEN; t++) {
+        seed = seed * 1103515245U + 12345U;
+        run = ((seed >> 16 & 1U) && run < DEBOUNCE_TICKS - 1) ? run + 1 : 0;
+        pattern[WORKLOAD_BOUNCE][t] = (uint8_t)(run > 0);
+    }
+    // Single click, double click, then a hold through long press
+    press(pattern[WORKLOAD_ACTIVE], 0, 15);
+    press(pattern[WORKLOAD_ACTIVE], 100, 112);
+    press(pattern[WORKLOAD_ACTIVE], 125, 137);
+    press(pattern[WORKLOAD_ACTIVE], 300, 700);
+
+    for (int i = 0; i < 256; i++) {
+        phase[i] = (uint16_t)((i * 37) & (PATTERN_LEN - 1));
+    }
+}
+
+static double run(Button* buttons, uint32_t count, Workload workload, int callbacks, uint32_t ticks)
+{
+    current_pattern = pattern[workload];
+    for (uint32_t i = 0; i < count; i++) {
+        button_init(&buttons[i], read_level, 1, (uint8_t)i);
+        if (callbacks) {
+            for (int ev = 0; ev < BTN_EVENT_COUNT; ev++) {
+                button_attach(&buttons[i], (ButtonEvent)ev, count_event, NULL);
+            }
+        }
+        button_start(&buttons[i]);
+    }
+
+    events = 0;
+    double t0 = now_ns();
+    for (bench_tick = 0; bench_tick < ticks; bench_tick++) {
+        button_ticks();
+    }
+    double t1 = now_ns();
+
+    for (uint32_t i = 0; i < count; i++) {
+        button_stop(&buttons[i]);
+    }
+    return (t1 - t0) / ((double)ticks * count);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t max_buttons = button_counts[sizeof(button_counts) / sizeof(button_counts[0]) - 1];
+    Button* buttons = malloc(max_buttons * sizeof(Button));
+    FILE* out = stdout;
+    int first = 1;
+
+    if (!buttons) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    if (argc > 1 && !(out = fopen(argv[1], "w"))) {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    build_patterns();
+
+    fprintf(out, "{\n  \"benchmark\": \"ticks\",\n  \"version\": \"%d.%d.%d\",\n",
+            MULTIBUTTON_VERSION_MAJOR, MULTIBUTTON_VERSION_MINOR, MULTIBUTTON_VERSION_PATCH);
+    fprintf(out, "  \"unit\": \"ns/button/tick\",\n  \"results\": [");
+    for (size_t n = 0; n < sizeof(button_counts) / sizeof(button_counts[0]); n++) {
+        uint32_t count = button_counts[n];
+        uint32_t ticks = (uint32_t)(WORK_PER_RUN / count);
+        if (ticks < MIN_TICKS) ticks = MIN_TICKS;
+
+        for (int w = 0; w < WORKLOAD_COUNT; w++) {
+            for (int callbacks = 0; callbacks <= 1; callbacks++) {
+                double ns = run(buttons, count, (Workload)w, callbacks, ticks);
+                fprintf(out, "%s\n    {\"buttons\": %u, \"workload\": \"%s\", \"callbacks\": %s, "
+                        "\"ticks\": %u, \"ns_per_button_tick\": %.3f, \"events\": %u}",
+                        first ? "" : ",", count, workload_names[w], callbacks ? "true" : "false",
+                        ticks, ns, events);
+                first = 0;
+            }
+        }
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    free(buttons);
+    return 0;
+}
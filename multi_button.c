@@ -5,38 +5,433 @@
 
 #include "multi_button.h"
 
-// Macro for callback execution with null check, passes user_data
-#define EVENT_CB(ev)   do { if (handle->cb[ev]) handle->cb[ev](handle, handle->user_data); } while(0)
+// Accessors for data kept either in the Button or in its shared ButtonConfig
+#ifdef MULTIBUTTON_CONST_CONFIG
+#define BUTTON_HAL(h)        ((h)->config->hal_button_level)
+#define BUTTON_CB(h, ev)     ((h)->config->cb[ev])
+#define BUTTON_USER_DATA(h)  ((h)->config->user_data)
+#else
+#define BUTTON_HAL(h)        ((h)->hal_button_level)
+#define BUTTON_CB(h, ev)     ((h)->cb[ev])
+#define BUTTON_USER_DATA(h)  ((h)->user_data)
+#endif
 
-// Button handle list head
-static Button* head_handle = NULL;
+// Macro for callback execution of a subscribed event (callback set), passes user_data
+#ifdef MULTIBUTTON_STATS
+#define EVENT_CALL(ev) do { \
+		uint32_t cb_start = MULTIBUTTON_CYCLES(); \
+		BUTTON_CB(handle, ev)(handle, BUTTON_USER_DATA(handle)); \
+		button_stats_callback(handle, MULTIBUTTON_CYCLES() - cb_start); \
+	} while(0)
+
+// Saturating counter increment
+#define STATS_INC(c)   do { if ((c) < UINT16_MAX) (c)++; } while(0)
+#else
+#define EVENT_CALL(ev) do { BUTTON_CB(handle, ev)(handle, BUTTON_USER_DATA(handle)); } while(0)
+#endif
+
+// Macro for callback execution with null check
+#define EVENT_CB(ev)   do { if (BUTTON_CB(handle, ev)) EVENT_CALL(ev); } while(0)
+
+#ifdef MULTIBUTTON_CONST_CONFIG
+// Configuration of port/edge buttons until button_set_config() is called
+static const ButtonConfig button_config_none = { NULL, { NULL }, NULL };
+#endif
+
+// Timing profile of buttons without button_set_profile()
+const ButtonProfile button_profile_default = { SHORT_TICKS, LONG_TICKS, DEBOUNCE_TICKS, 0, 0, 0, 0 };
+
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+// Queued event values with these bits set are gesture table indices or chord events
+#define QUEUED_GESTURE       0x80U
+#define QUEUED_CHORD         0x40U
+#define QUEUED_INDEX_MASK    0x3FU
+#endif
+
+// Event mask bit of an event emitted by the state machine
+#define BTN_EVENT_BIT(ev)   ((uint8_t)(1U << (ev)))
+
+// ButtonPool packed hot state layout
+#define POOL_STATE_MASK      0x07U   // flags: state machine state
+#define POOL_DEBOUNCE_SHIFT  3       // flags: debounce counter position
+#define POOL_DEBOUNCE_MASK   0x38U   // flags: debounce counter
+#define POOL_LEVEL_BIT       0x40U   // flags: debounced button level
+#define POOL_ACTIVE_BIT      0x80U   // flags: active level
+#define POOL_REPEAT_MASK     0x0FU   // repeat: repeat counter
+#define POOL_EVENT_SHIFT     4       // repeat: current event position
+
+// State machine working copy of the hot button state
+typedef struct {
+	uint16_t ticks;
+	uint8_t  state;
+	uint8_t  repeat;
+#ifdef MULTIBUTTON_TYPEMATIC
+	uint16_t hold;                      // typematic repeats since BTN_LONG_PRESS_START
+#endif
+} ButtonFsm;
+
+// Typematic hold repeat of a profile (hold_interval set)
+#ifdef MULTIBUTTON_TYPEMATIC
+#define BUTTON_TYPEMATIC(p)  ((p)->hold_interval != 0)
+#else
+#define BUTTON_TYPEMATIC(p)  0
+#endif
+
+// Group of the functions without a group parameter, and of buttons not started yet
+static ButtonGroup group_default;
+
+// Group a button is ticked in; without groups the group variants of the functions are internal
+#ifdef MULTIBUTTON_GROUPS
+#define BUTTON_GROUP(h)      ((h)->group)
+#define BUTTON_GROUP_API
+#else
+#define BUTTON_GROUP(h)      ((void)(h), &group_default)
+#define BUTTON_GROUP_API     static
+#endif
+
+// Timing profile of a button
+#ifdef MULTIBUTTON_PROFILES
+#define BUTTON_PROFILE(h)    ((h)->profile)
+#else
+#define BUTTON_PROFILE(h)    ((void)(h), &button_profile_default)
+#endif
+
+// Membership of a button in a list
+#ifdef MULTIBUTTON_FAST_STOP
+#define BUTTON_LINKED(h)     ((h)->pprev != NULL)
+#else
+#define BUTTON_LINKED(h)     ((h)->linked)
+#endif
+
+// List links are read without the lock while ticking
+#define BUTTON_LINK(p) (*(Button* volatile*)&(p))
+#ifdef MULTIBUTTON_CHORDS
+#define BUTTON_CHORD_LINK(p) (*(ButtonChord* volatile*)&(p))
+#endif
+
+// Tick pass bracket for button_group_synchronize(), only needed with concurrent threads
+#ifdef MULTIBUTTON_THREAD_SAFE
+#define BUTTON_PASS_BEGIN(g) do { (g)->passes++; MULTIBUTTON_BARRIER(); } while (0)
+#define BUTTON_PASS_END(g)   do { MULTIBUTTON_BARRIER(); (g)->passes++; } while (0)
+#else
+#define BUTTON_PASS_BEGIN(g) do { } while (0)
+#define BUTTON_PASS_END(g)   do { } while (0)
+#endif
 
 // Forward declarations
 static void button_handler(Button* handle);
+static void button_debounce(Button* handle);
+static void button_step(Button* handle);
 static inline uint8_t button_read_level(Button* handle);
+static uint16_t button_deadline(Button* handle);
+#ifdef MULTIBUTTON_CHORDS
+static void button_chord_eval(ButtonGroup* group, uint32_t pressed, uint32_t ticks);
+#endif
 
+#ifdef MULTIBUTTON_STATS
 /**
-  * @brief  Initialize the button struct handle
+  * @brief  Record the duration of an event callback
   * @param  handle: the button handle struct
-  * @param  pin_level: read the HAL GPIO of the connected button level
+  * @param  cycles: MULTIBUTTON_CYCLES() spent in the callback
+  * @retval None
+  */
+static inline void button_stats_callback(Button* handle, uint32_t cycles)
+{
+	if (cycles > handle->stats.max_cb_cycles) {
+		handle->stats.max_cb_cycles = cycles;
+	}
+}
+
+/**
+  * @brief  Record the duration of one tick in the log2 histogram
+  * @param  group: the group that was ticked
+  * @param  cycles: MULTIBUTTON_CYCLES() spent in the tick
+  * @retval None
+  */
+static void button_stats_tick(ButtonGroup* group, uint32_t cycles)
+{
+	ButtonTickStats* stats = &group->tick_stats;
+	uint8_t bucket = 0;
+
+	for (uint32_t c = cycles; c && bucket < BUTTON_STATS_BUCKETS - 1; c >>= 1) {
+		bucket++;
+	}
+	stats->hist[bucket]++;
+	stats->count++;
+	if (cycles > stats->max_cycles) {
+		stats->max_cycles = cycles;
+	}
+}
+#endif
+
+/**
+  * @brief  Clear a button struct to an idle button of the default group, not started
+  * @param  handle: the button handle struct
+  * @param  input: input source (ButtonInput)
   * @param  active_level: pressed GPIO level
   * @param  button_id: the button id
   * @retval None
   */
-void button_init(Button* handle, uint8_t(*pin_level)(uint8_t), uint8_t active_level, uint8_t button_id)
+static void button_clear(Button* handle, uint8_t input, uint8_t active_level, uint8_t button_id)
 {
-	if (!handle || !pin_level) return;  // parameter validation
-
 	memset(handle, 0, sizeof(Button));
 	handle->event = (uint8_t)BTN_NONE_PRESS;
-	handle->hal_button_level = pin_level;
+	handle->input = input;
 	handle->button_level = !active_level;  // initialize to opposite of active level
 	handle->active_level = active_level;
 	handle->button_id = button_id;
 	handle->state = BTN_STATE_IDLE;
+#ifdef MULTIBUTTON_CONST_CONFIG
+	handle->config = &button_config_none;
+#endif
+#ifdef MULTIBUTTON_PROFILES
+	handle->profile = &button_profile_default;
+#endif
+#ifdef MULTIBUTTON_GROUPS
+	handle->group = &group_default;
+#endif
+}
+
+#ifndef MULTIBUTTON_CONST_CONFIG
+/**
+  * @brief  Initialize the button struct handle
+  * @param  handle: the button handle struct
+  * @param  pin_level: read the HAL GPIO of the connected button level
+  * @param  active_level: pressed GPIO level
+  * @param  button_id: the button id
+  * @retval None
+  */
+void button_init(Button* handle, uint8_t(*pin_level)(uint8_t), uint8_t active_level, uint8_t button_id)
+{
+	if (!handle || !pin_level) return;  // parameter validation
+
+	button_clear(handle, BTN_INPUT_PIN, active_level, button_id);
+	handle->hal_button_level = pin_level;
 	// user_data is zeroed by memset
 }
+#endif
+
+#ifdef MULTIBUTTON_GROUPS
+/**
+  * @brief  Initialize a button group: empty list, no port reader
+  * @param  group: the group struct
+  * @retval None
+  */
+void button_group_init(ButtonGroup* group)
+{
+	if (!group) return;  // parameter validation
+
+	memset(group, 0, sizeof(ButtonGroup));
+}
+#endif
+
+#if MULTIBUTTON_MAX_PORTS > 0
+/**
+  * @brief  Set the port read function used by port-mapped buttons of a group
+  * @param  group: the group struct
+  * @param  read_port: returns the 32-bit input word of the given port
+  * @retval None
+  */
+BUTTON_GROUP_API void button_group_port_init(ButtonGroup* group, BtnPortRead read_port)
+{
+	if (!group) return;  // parameter validation
+
+	group->port_read = read_port;
+	group->port_sampled = 0;
+}
+
+/**
+  * @brief  Set the port read function used by port-mapped buttons
+  * @param  read_port: returns the 32-bit input word of the given port
+  * @retval None
+  */
+void button_port_init(BtnPortRead read_port)
+{
+	button_group_port_init(&group_default, read_port);
+}
+
+/**
+  * @brief  Request a seed of the port debounce state with the current level of a pin
+  *         The pin's debounced level follows the button's own, so starting a
+  *         held button again does not report a release. The debounce state
+  *         belongs to the tick, which applies the seed at the port's next
+  *         sample (button_port_seed()); the request only writes fields the
+  *         tick reads. A request still pending keeps its place and takes
+  *         the new level. Called under MULTIBUTTON_LOCK().
+  * @param  group: the group the button is ticked in
+  * @param  handle: the button handle struct (BTN_INPUT_PORT)
+  * @retval None
+  */
+static void button_port_request_seed(ButtonGroup* group, Button* handle)
+{
+	uint8_t port = handle->port;
+	uint32_t mask = handle->pin_mask;
+
+	if (handle->button_level) {
+		group->port_seed_level[port] |= mask;
+	} else {
+		group->port_seed_level[port] &= ~mask;
+	}
+	MULTIBUTTON_BARRIER();  // level visible before the request
+	group->port_seed_req[port] ^= mask & ~(group->port_seed_req[port] ^ group->port_seed_done[port]);
+}
+
+/**
+  * @brief  Apply pending seed requests to the debounce state of a port
+  *         Runs in the tick context before the port is debounced.
+  * @param  group: the group owning the port
+  * @param  port: port index
+  * @param  seed: pins with a pending request
+  * @retval None
+  */
+static void button_port_seed(ButtonGroup* group, uint8_t port, uint32_t seed)
+{
+	ButtonDebounce* db = &group->port_debounce[port];
+	ButtonSlice mask = (ButtonSlice)seed;
+
+	MULTIBUTTON_BARRIER();  // request seen before reading its level
+	db->level = (db->level & ~mask) | ((ButtonSlice)group->port_seed_level[port] & mask);
+	db->cnt[0] &= ~mask;
+	db->cnt[1] &= ~mask;
+	db->cnt[2] &= ~mask;
+	group->port_seed_done[port] ^= seed;
+}
+
+/**
+  * @brief  Initialize a button mapped to a bit of a GPIO port word
+  *         All buttons on the same port share a single port read per tick.
+  * @param  handle: the button handle struct
+  * @param  port: port index (0 ~ MULTIBUTTON_MAX_PORTS-1)
+  * @param  pin_mask: bit mask of the button pin within the port word
+  * @param  active_level: pressed GPIO level
+  * @param  button_id: the button id
+  * @retval None
+  */
+void button_init_port(Button* handle, uint8_t port, uint32_t pin_mask, uint8_t active_level, uint8_t button_id)
+{
+	if (!handle || port >= MULTIBUTTON_MAX_PORTS || !pin_mask) return;  // parameter validation
+
+	button_clear(handle, BTN_INPUT_PORT, active_level, button_id);
+	handle->port = port;
+	handle->pin_mask = pin_mask;  // port debounce state is seeded after button_group_start()
+}
+
+/**
+  * @brief  Initialize a matrix keypad and attach it to port words of a group
+  *         Rows up to 4 use port 'port', more rows also use 'port + 1'.
+  *         Its keys are read by port-mapped buttons (button_matrix_init_key()).
+  * @param  group: the group the keys are ticked in
+  * @param  matrix: the matrix struct
+  * @param  rows: number of rows (1 ~ 8)
+  * @param  cols: number of columns (1 ~ 8)
+  * @param  drive_row: makes one row active
+  * @param  read_cols: reads the columns of the active row, bit set = key closed
+  * @param  port: first port word (0 ~ MULTIBUTTON_MAX_PORTS-1)
+  * @retval 0: succeed, -2: invalid parameter
+  */
+BUTTON_GROUP_API int button_group_matrix_init(ButtonGroup* group, ButtonMatrix* matrix, uint8_t rows, uint8_t cols,
+                             BtnMatrixDrive drive_row, BtnMatrixRead read_cols, uint8_t port)
+{
+	if (!group || !matrix || !drive_row || !read_cols) return -2;  // invalid parameter
+	if (rows < 1 || rows > 8 || cols < 1 || cols > 8) return -2;
+	uint8_t ports = (rows > 4) ? 2 : 1;  // port words of the snapshot
+	if (port + ports > MULTIBUTTON_MAX_PORTS) return -2;
+
+	memset(matrix, 0, sizeof(ButtonMatrix));
+	matrix->drive_row = drive_row;
+	matrix->read_cols = read_cols;
+	matrix->rows = rows;
+	matrix->cols = cols;
+	matrix->port = port;
+	for (uint8_t p = 0; p < ports; p++) {
+		group->port_matrix[port + p] = matrix;
+	}
+	return 0;
+}
+
+/**
+  * @brief  Initialize a matrix keypad and attach it to its port words
+  *         See button_group_matrix_init(), operates on the default group.
+  * @retval 0: succeed, -2: invalid parameter
+  */
+int button_matrix_init(ButtonMatrix* matrix, uint8_t rows, uint8_t cols,
+                       BtnMatrixDrive drive_row, BtnMatrixRead read_cols, uint8_t port)
+{
+	return button_group_matrix_init(&group_default, matrix, rows, cols, drive_row, read_cols, port);
+}
+
+/**
+  * @brief  Initialize a button for one key of a matrix keypad
+  * @param  handle: the button handle struct
+  * @param  matrix: the matrix the key belongs to
+  * @param  row: key row
+  * @param  col: key column
+  * @param  button_id: the button id
+  * @retval None
+  */
+void button_matrix_init_key(Button* handle, ButtonMatrix* matrix, uint8_t row, uint8_t col, uint8_t button_id)
+{
+	if (!handle || !matrix || row >= matrix->rows || col >= matrix->cols) return;  // parameter validation
+
+	uint8_t bit = (uint8_t)(row * 8 + col);
+	button_init_port(handle, (uint8_t)(matrix->port + bit / 32), 1UL << (bit % 32), 1, button_id);
+}
+#endif
+
+#ifdef MULTIBUTTON_TIME_DRIVEN
+/**
+  * @brief  Initialize an edge-driven button
+  *         The level is reported by button_on_edge() from a GPIO interrupt
+  *         instead of being polled by button_ticks().
+  * @param  handle: the button handle struct
+  * @param  active_level: pressed GPIO level
+  * @param  button_id: the button id
+  * @retval None
+  */
+void button_init_edge(Button* handle, uint8_t active_level, uint8_t button_id)
+{
+	if (!handle) return;  // parameter validation
+
+	button_clear(handle, BTN_INPUT_EDGE, active_level, button_id);
+}
+#endif
+
+/**
+  * @brief  Bit-sliced debounce of a word of inputs
+  *         Each bit behaves exactly like the per-button debounce_cnt filter:
+  *         a level change is accepted after DEBOUNCE_TICKS consecutive samples.
+  * @param  db: debounce state (counter bit planes and debounced levels)
+  * @param  raw: raw input levels sampled this tick
+  * @retval debounced input levels
+  */
+ButtonSlice button_debounce_slice(ButtonDebounce* db, ButtonSlice raw)
+{
+	if (!db) return raw;
+
+	// Inputs that differ from the debounced level count up, the others reset
+	ButtonSlice delta = raw ^ db->level;
+	ButtonSlice carry = db->cnt[0] & delta;
+	ButtonSlice c0 = ~db->cnt[0] & delta;
+	ButtonSlice c1 = (db->cnt[1] ^ carry) & delta;
+	carry &= db->cnt[1];
+	ButtonSlice c2 = (db->cnt[2] ^ carry) & delta;
+
+	// Inputs whose counter reached DEBOUNCE_TICKS take the new level
+	ButtonSlice hit = delta;
+#if DEBOUNCE_TICKS > 1
+	hit &= (DEBOUNCE_TICKS & 1) ? c0 : ~c0;
+	hit &= (DEBOUNCE_TICKS & 2) ? c1 : ~c1;
+	hit &= (DEBOUNCE_TICKS & 4) ? c2 : ~c2;
+#endif
+
+	db->level ^= hit;
+	db->cnt[0] = c0 & ~hit;
+	db->cnt[1] = c1 & ~hit;
+	db->cnt[2] = c2 & ~hit;
+	return db->level;
+}
 
+#ifndef MULTIBUTTON_CONST_CONFIG
 /**
   * @brief  Attach the button event callback function
   * @param  handle: the button handle struct
@@ -50,6 +445,11 @@ void button_attach(Button* handle, ButtonEvent event, BtnCallback cb, void* user
 	if (!handle || event >= BTN_EVENT_COUNT) return;  // parameter validation
 	handle->cb[event] = cb;
 	handle->user_data = user_data;
+	if (cb) {
+		handle->cb_mask |= BTN_EVENT_BIT(event);
+	} else {
+		handle->cb_mask &= (uint8_t)~BTN_EVENT_BIT(event);
+	}
 }
 
 /**
@@ -62,7 +462,90 @@ void button_detach(Button* handle, ButtonEvent event)
 {
 	if (!handle || event >= BTN_EVENT_COUNT) return;  // parameter validation
 	handle->cb[event] = NULL;
+	handle->cb_mask &= (uint8_t)~BTN_EVENT_BIT(event);
+}
+#endif
+
+/**
+  * @brief  Initialize a pin button from a configuration
+  *         With MULTIBUTTON_CONST_CONFIG the configuration is referenced and
+  *         may be shared by many buttons; otherwise it is copied.
+  * @param  handle: the button handle struct
+  * @param  config: HAL read function, callbacks and user_data
+  * @param  active_level: pressed GPIO level
+  * @param  button_id: the button id
+  * @retval None
+  */
+void button_init_config(Button* handle, const ButtonConfig* config, uint8_t active_level, uint8_t button_id)
+{
+	if (!handle || !config || !config->hal_button_level) return;  // parameter validation
+
+	button_clear(handle, BTN_INPUT_PIN, active_level, button_id);
+	button_set_config(handle, config);
+}
+
+/**
+  * @brief  Set the callbacks and user_data of a button from a configuration
+  *         Used for port-mapped and edge-driven buttons, which have no HAL
+  *         read function; the configuration's hal_button_level is ignored.
+  * @param  handle: the button handle struct
+  * @param  config: callbacks and user_data
+  * @retval None
+  */
+void button_set_config(Button* handle, const ButtonConfig* config)
+{
+	if (!handle || !config) return;  // parameter validation
+
+#ifdef MULTIBUTTON_CONST_CONFIG
+	handle->config = config;
+#else
+	if (handle->input == BTN_INPUT_PIN) {
+		handle->hal_button_level = config->hal_button_level;
+	}
+	memcpy(handle->cb, config->cb, sizeof(handle->cb));
+	handle->user_data = config->user_data;
+#endif
+
+	// Subscribed events, taken from the configuration once
+	handle->cb_mask = 0;
+	for (uint8_t ev = 0; ev < BTN_EVENT_COUNT; ev++) {
+		if (config->cb[ev]) {
+			handle->cb_mask |= BTN_EVENT_BIT(ev);
+		}
+	}
+}
+
+#ifdef MULTIBUTTON_PROFILES
+/**
+  * @brief  Set the timing profile of a button
+  *         The profile is referenced, not copied, and may be shared by many buttons.
+  *         Port-mapped buttons keep the global DEBOUNCE_TICKS (debounced per port word).
+  * @param  handle: the button handle struct
+  * @param  profile: timing thresholds, debounce_ticks at most 7
+  * @retval None
+  */
+void button_set_profile(Button* handle, const ButtonProfile* profile)
+{
+	if (!handle || !profile || profile->debounce_ticks > 7) return;  // parameter validation
+	handle->profile = profile;
+}
+#endif
+
+#ifdef MULTIBUTTON_GESTURES
+/**
+  * @brief  Set the press-sequence gestures recognized for a button
+  *         The table is referenced, not copied; it ends with an entry whose
+  *         presses is 0. The first matching entry fires. Pools do not support gestures.
+  * @param  handle: the button handle struct
+  * @param  gestures: gesture table, NULL to disable
+  * @retval None
+  */
+void button_set_gestures(Button* handle, const ButtonGesture* gestures)
+{
+	if (!handle) return;  // parameter validation
+	handle->gestures = gestures;
 }
+#endif
 
 /**
   * @brief  Get the button event that happened
@@ -75,6 +558,24 @@ ButtonEvent button_get_event(Button* handle)
 	return (ButtonEvent)(handle->event);
 }
 
+/**
+  * @brief  Get the event a callback was invoked for
+  *         With deferred dispatch the live event may already be a later one;
+  *         while button_dispatch_pending() runs a callback of the button this
+  *         returns the queued event instead. Otherwise it is the same as
+  *         button_get_event(). Call it from callbacks (consumer side) only.
+  * @param  handle: the button handle struct
+  * @retval button event
+  */
+ButtonEvent button_get_dispatched_event(Button* handle)
+{
+	if (!handle) return BTN_NONE_PRESS;
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+	if (BUTTON_GROUP(handle)->queue_source == handle) return (ButtonEvent)BUTTON_GROUP(handle)->queue_event;
+#endif
+	return (ButtonEvent)(handle->event);
+}
+
 /**
   * @brief  Get the repeat count of button presses
   * @param  handle: the button handle struct
@@ -99,6 +600,12 @@ void button_reset(Button* handle)
 	handle->repeat = 0;
 	handle->event = (uint8_t)BTN_NONE_PRESS;
 	handle->debounce_cnt = 0;
+#ifdef MULTIBUTTON_TIME_DRIVEN
+	handle->edge_pending = 0;
+#endif
+#ifdef MULTIBUTTON_GESTURES
+	handle->seq = 0;
+#endif
 }
 
 /**
@@ -112,210 +619,2124 @@ int button_is_pressed(Button* handle)
 	return (handle->button_level == handle->active_level) ? 1 : 0;
 }
 
+#if MULTIBUTTON_MAX_PORTS > 0
 /**
-  * @brief  Read button level with inline optimization
-  * @param  handle: the button handle struct
-  * @retval button level
+  * @brief  Number of port words fed by a matrix snapshot
+  * @param  matrix: the matrix
+  * @retval 1 or 2
   */
-static inline uint8_t button_read_level(Button* handle)
+static inline uint8_t button_matrix_ports(const ButtonMatrix* matrix)
 {
-	return handle->hal_button_level(handle->button_id);
+	return (matrix->rows > 4) ? 2 : 1;
 }
 
 /**
-  * @brief  Button driver core function, driver state machine
-  * @param  handle: the button handle struct
+  * @brief  Scan a matrix keypad: drive each row once, read all columns at once
+  *         Without diodes, three closed keys on the corners of a rectangle make
+  *         the fourth corner read closed too. A scan where two rows share two or
+  *         more closed columns is ambiguous and keeps the previous snapshot.
+  * @param  matrix: the matrix
   * @retval None
   */
-static void button_handler(Button* handle)
+static void button_matrix_scan(ButtonMatrix* matrix)
 {
-	uint8_t read_gpio_level = button_read_level(handle);
+	uint8_t row_bits[8];
+	uint8_t col_mask = (uint8_t)((1U << matrix->cols) - 1U);
+	uint64_t snapshot = 0;
 
-	// Increment ticks counter when not in idle state (with saturation)
-	if (handle->state > BTN_STATE_IDLE) {
-		if (handle->ticks < UINT16_MAX) {
-			handle->ticks++;
-		}
+	for (uint8_t r = 0; r < matrix->rows; r++) {
+		matrix->drive_row(r);
+		row_bits[r] = matrix->read_cols() & col_mask;
+		snapshot |= (uint64_t)row_bits[r] << (r * 8);
 	}
 
-	/* Button debounce handling */
-	if (read_gpio_level != handle->button_level) {
-		// Continue reading same new level for debounce
-		if (++(handle->debounce_cnt) >= DEBOUNCE_TICKS) {
-			handle->button_level = read_gpio_level;
-			handle->debounce_cnt = 0;
+	// Ghost check: pairs of rows with two or more common columns
+	for (uint8_t r = 0; r < matrix->rows; r++) {
+		for (uint8_t q = (uint8_t)(r + 1); q < matrix->rows; q++) {
+			uint8_t common = row_bits[r] & row_bits[q];
+			if (common & (common - 1U)) {
+				matrix->ghosted = 1;
+				matrix->ghost_count++;
+				return;
+			}
 		}
-	} else {
-		// Level not changed, reset counter
-		handle->debounce_cnt = 0;
 	}
+	matrix->ghosted = 0;
+	matrix->snapshot = snapshot;
+}
 
-	/* State machine */
-	switch (handle->state) {
-	case BTN_STATE_IDLE:
-		if (handle->button_level == handle->active_level) {
-			// Button press detected
-			handle->event = (uint8_t)BTN_PRESS_DOWN;
-			EVENT_CB(BTN_PRESS_DOWN);
-			handle->ticks = 0;
-			handle->repeat = 1;
-			handle->state = BTN_STATE_PRESS;
-		} else {
-			handle->event = (uint8_t)BTN_NONE_PRESS;
-		}
-		break;
+/**
+  * @brief  Read a port word from the port reader or the matrix owning it
+  *         A matrix is scanned on the first read of any of its ports this tick.
+  * @param  group: the group owning the port
+  * @param  port: port index
+  * @retval 32-bit input word
+  */
+static uint32_t button_port_fetch(ButtonGroup* group, uint8_t port)
+{
+	ButtonMatrix* matrix = group->port_matrix[port];
 
-	case BTN_STATE_PRESS:
-		if (handle->button_level != handle->active_level) {
-			// Button released
-			handle->event = (uint8_t)BTN_PRESS_UP;
-			EVENT_CB(BTN_PRESS_UP);
-			handle->ticks = 0;
-			handle->state = BTN_STATE_RELEASE;
-		} else if (handle->ticks > LONG_TICKS) {
-			// Long press detected
-			handle->event = (uint8_t)BTN_LONG_PRESS_START;
-			EVENT_CB(BTN_LONG_PRESS_START);
-			handle->state = BTN_STATE_LONG_HOLD;
+	if (matrix) {
+		uint32_t ports = ((1UL << button_matrix_ports(matrix)) - 1UL) << matrix->port;
+		if (!(group->port_sampled & ports)) {
+			button_matrix_scan(matrix);
 		}
-		break;
+		return (uint32_t)(matrix->snapshot >> (32U * (uint8_t)(port - matrix->port)));
+	}
+	return group->port_read ? group->port_read(port) : 0;
+}
+#endif
 
-	case BTN_STATE_RELEASE:
-		if (handle->button_level == handle->active_level) {
-			// Button pressed again
-			handle->event = (uint8_t)BTN_PRESS_DOWN;
-			EVENT_CB(BTN_PRESS_DOWN);
-			if (handle->repeat < PRESS_REPEAT_MAX_NUM) {
-				handle->repeat++;
-			}
-			handle->event = (uint8_t)BTN_PRESS_REPEAT;
-			EVENT_CB(BTN_PRESS_REPEAT);
-			handle->ticks = 0;
-			handle->state = BTN_STATE_REPEAT;
-		} else if (handle->ticks > SHORT_TICKS) {
-			// Timeout reached, determine click type
-			if (handle->repeat == 1) {
-				handle->event = (uint8_t)BTN_SINGLE_CLICK;
-				EVENT_CB(BTN_SINGLE_CLICK);
-			} else if (handle->repeat == 2) {
-				handle->event = (uint8_t)BTN_DOUBLE_CLICK;
-				EVENT_CB(BTN_DOUBLE_CLICK);
-			}
-			handle->state = BTN_STATE_IDLE;
-		}
-		break;
+/**
+  * @brief  Read button level with inline optimization
+  * @param  handle: the button handle struct
+  * @retval button level (already debounced for port-mapped buttons)
+  */
+static inline uint8_t button_read_level(Button* handle)
+{
+#if MULTIBUTTON_MAX_PORTS > 0
+	if (handle->input == BTN_INPUT_PORT) {
+		ButtonGroup* group = BUTTON_GROUP(handle);
+		uint32_t bit = 1UL << handle->port;
 
-	case BTN_STATE_REPEAT:
-		if (handle->button_level != handle->active_level) {
-			// Button released
-			handle->event = (uint8_t)BTN_PRESS_UP;
-			EVENT_CB(BTN_PRESS_UP);
-			if (handle->ticks < SHORT_TICKS) {
-				handle->ticks = 0;
-				handle->state = BTN_STATE_RELEASE;  // Continue waiting for more presses
-			} else {
-				handle->state = BTN_STATE_IDLE;  // End of sequence
+		// Sample and debounce each port at most once per tick
+		if (!(group->port_sampled & bit)) {
+			ButtonDebounce* db = &group->port_debounce[handle->port];
+			uint32_t seed = group->port_seed_req[handle->port] ^ group->port_seed_done[handle->port];
+			if (seed) {
+				button_port_seed(group, handle->port, seed);  // buttons started since the last sample
 			}
-		} else if (handle->ticks > SHORT_TICKS) {
-			// Held down too long, treat as normal press
-			handle->ticks = 0;      // reset for fresh long-press timing
-			handle->repeat = 0;     // clear repeat count for new press cycle
-			handle->state = BTN_STATE_PRESS;
-		}
-		break;
-
-	case BTN_STATE_LONG_HOLD:
-		if (handle->button_level == handle->active_level) {
-			// Continue holding
-			handle->event = (uint8_t)BTN_LONG_PRESS_HOLD;
-			EVENT_CB(BTN_LONG_PRESS_HOLD);
-		} else {
-			// Released from long press
-			handle->event = (uint8_t)BTN_PRESS_UP;
-			EVENT_CB(BTN_PRESS_UP);
-			handle->state = BTN_STATE_IDLE;
+#ifdef MULTIBUTTON_STATS
+			ButtonSlice counting = db->cnt[0] | db->cnt[1] | db->cnt[2];
+			ButtonSlice level = db->level;
+#endif
+			group->port_raw[handle->port] = button_port_fetch(group, handle->port);
+			button_debounce_slice(db, group->port_raw[handle->port]);
+#ifdef MULTIBUTTON_STATS
+			// Counting pins that reset without taking the new level bounced back
+			group->port_rejected[handle->port] = (uint32_t)(counting & ~(db->cnt[0] | db->cnt[1] | db->cnt[2]) & ~(db->level ^ level));
+#endif
+			group->port_sampled |= bit;
 		}
-		break;
-
-	default:
-		// Invalid state, reset to idle
-		handle->state = BTN_STATE_IDLE;
-		break;
+		return (group->port_debounce[handle->port].level & handle->pin_mask) ? 1 : 0;
 	}
+#endif
+	return BUTTON_HAL(handle)(handle->button_id);
 }
 
+#ifdef MULTIBUTTON_TIME_DRIVEN
 /**
-  * @brief  Start the button work, add the handle into work list
-  * @param  handle: target handle struct
-  * @retval 0: succeed, -1: already exist, -2: invalid parameter
+  * @brief  Read raw (not debounced) button level for time-driven sampling
+  * @param  handle: the button handle struct (pin or port input)
+  * @retval button level
   */
-int button_start(Button* handle)
+static inline uint8_t button_read_raw(Button* handle)
 {
-	if (!handle) return -2;  // invalid parameter
+#if MULTIBUTTON_MAX_PORTS > 0
+	if (handle->input == BTN_INPUT_PORT) {
+		ButtonGroup* group = BUTTON_GROUP(handle);
+		uint32_t bit = 1UL << handle->port;
 
-	MULTIBUTTON_LOCK();
-	Button* target = head_handle;
-	while (target) {
-		if (target == handle) {
-			MULTIBUTTON_UNLOCK();
-			return -1;  // already exist
+		// Sample each port at most once per call
+		if (!(group->port_sampled & bit)) {
+			group->port_raw[handle->port] = button_port_fetch(group, handle->port);
+			group->port_sampled |= bit;
 		}
-		target = target->next;
+		return (group->port_raw[handle->port] & handle->pin_mask) ? 1 : 0;
 	}
+#endif
+	return BUTTON_HAL(handle)(handle->button_id);
+}
+#endif
 
-	handle->next = head_handle;
-	head_handle = handle;
+/**
+  * @brief  Load the state machine working copy of a list button
+  * @param  handle: the button handle struct
+  * @retval working copy
+  */
+static inline ButtonFsm button_fsm_load(const Button* handle)
+{
+	ButtonFsm fsm;
+
+	fsm.ticks = handle->ticks;
+	fsm.state = handle->state;
+	fsm.repeat = handle->repeat;
+#ifdef MULTIBUTTON_TYPEMATIC
+	fsm.hold = handle->hold;
+#endif
+	return fsm;
+}
+
+/**
+  * @brief  Store the state machine working copy of a list button
+  * @param  handle: the button handle struct
+  * @param  fsm: working copy
+  * @retval None
+  */
+static inline void button_fsm_store(Button* handle, const ButtonFsm* fsm)
+{
+	handle->ticks = fsm->ticks;
+	handle->repeat = fsm->repeat;
+	handle->state = fsm->state;
+#ifdef MULTIBUTTON_TYPEMATIC
+	handle->hold = fsm->hold;
+#endif
+}
+
+#ifdef MULTIBUTTON_TYPEMATIC
+/**
+  * @brief  Typematic hold: ticks from the previous BTN_LONG_PRESS_HOLD (or from
+  *         BTN_LONG_PRESS_START) to the next one
+  * @param  fsm: state machine working copy (BTN_STATE_LONG_HOLD)
+  * @param  profile: timing thresholds (hold_interval set)
+  * @retval ticks to wait, at least 1
+  */
+static inline uint16_t button_hold_wait(const ButtonFsm* fsm, const ButtonProfile* profile)
+{
+	uint16_t wait = profile->hold_interval;
+
+	if (!fsm->hold) {
+		wait = profile->hold_delay;
+	} else if (profile->hold_accel) {
+		uint16_t shift = (uint16_t)((fsm->hold - 1) / profile->hold_accel);
+		wait = (shift < 16) ? (uint16_t)(wait >> shift) : 0;
+		if (wait < profile->hold_min_interval) {
+			wait = profile->hold_min_interval;
+		}
+	}
+	return wait ? wait : 1;
+}
+
+/**
+  * @brief  Typematic hold step: emit BTN_LONG_PRESS_HOLD once the wait has elapsed
+  * @param  fsm: state machine working copy (BTN_STATE_LONG_HOLD, ticks already counted)
+  * @param  profile: timing thresholds (hold_interval set)
+  * @retval mask of emitted events
+  */
+static inline uint8_t button_hold_step(ButtonFsm* fsm, const ButtonProfile* profile)
+{
+	if (fsm->ticks < button_hold_wait(fsm, profile)) return 0;
+
+	fsm->ticks = 0;
+	if (fsm->hold < UINT16_MAX) {
+		fsm->hold++;
+	}
+	return BTN_EVENT_BIT(BTN_LONG_PRESS_HOLD);
+}
+#endif
+
+#ifdef MULTIBUTTON_FSM_TABLE
+// Transition actions applied after a table lookup
+#define FSM_TICKS_RESET      0x01U   // restart the tick counter
+#define FSM_REPEAT_SET       0x02U   // repeat = 1 (first press)
+#define FSM_REPEAT_INC       0x04U   // repeat++ up to PRESS_REPEAT_MAX_NUM
+#define FSM_REPEAT_CLEAR     0x08U   // repeat = 0
+#define FSM_CLICK            0x10U   // emit single/double click from the repeat count
+
+// Timeout condition of a (state, pressed) pair
+#define FSM_LIMIT_NONE       0x00U   // no time-based transition
+#define FSM_LIMIT_SHORT      0x01U   // ticks > short_ticks
+#define FSM_LIMIT_LONG       0x02U   // ticks > long_ticks
+#define FSM_LIMIT_EQUAL      0x04U   // also expired when ticks == limit
+
+// Transition table entry
+typedef struct {
+	uint8_t next;                       // next state
+	uint8_t events;                     // emitted events, BTN_EVENT_BIT(ev)
+	uint8_t action;                     // FSM_* actions
+} ButtonFsmEntry;
+
+#define FSM_STATE_COUNT      (BTN_STATE_LONG_HOLD + 1)
+#define FSM_EV(ev)           BTN_EVENT_BIT(ev)
+
+// Timeout condition indexed by [state][pressed]
+static const uint8_t button_fsm_limit[FSM_STATE_COUNT][2] = {
+	[BTN_STATE_IDLE]      = { FSM_LIMIT_NONE, FSM_LIMIT_NONE },
+	[BTN_STATE_PRESS]     = { FSM_LIMIT_NONE, FSM_LIMIT_LONG },
+	[BTN_STATE_RELEASE]   = { FSM_LIMIT_SHORT, FSM_LIMIT_NONE },
+	[BTN_STATE_REPEAT]    = { FSM_LIMIT_SHORT | FSM_LIMIT_EQUAL, FSM_LIMIT_SHORT },
+	[BTN_STATE_LONG_HOLD] = { FSM_LIMIT_NONE, FSM_LIMIT_NONE },
+};
+
+// Transitions indexed by [state][pressed][timeout expired]
+static const ButtonFsmEntry button_fsm_table[FSM_STATE_COUNT][2][2] = {
+	[BTN_STATE_IDLE] = {
+		{ { BTN_STATE_IDLE, 0, 0 }, { BTN_STATE_IDLE, 0, 0 } },
+		{ { BTN_STATE_PRESS, FSM_EV(BTN_PRESS_DOWN), FSM_TICKS_RESET | FSM_REPEAT_SET },
+		  { BTN_STATE_PRESS, FSM_EV(BTN_PRESS_DOWN), FSM_TICKS_RESET | FSM_REPEAT_SET } },
+	},
+	[BTN_STATE_PRESS] = {
+		{ { BTN_STATE_RELEASE, FSM_EV(BTN_PRESS_UP), FSM_TICKS_RESET },
+		  { BTN_STATE_RELEASE, FSM_EV(BTN_PRESS_UP), FSM_TICKS_RESET } },
+		{ { BTN_STATE_PRESS, 0, 0 }, { BTN_STATE_LONG_HOLD, FSM_EV(BTN_LONG_PRESS_START), 0 } },
+	},
+	[BTN_STATE_RELEASE] = {
+		{ { BTN_STATE_RELEASE, 0, 0 }, { BTN_STATE_IDLE, 0, FSM_CLICK } },
+		{ { BTN_STATE_REPEAT, FSM_EV(BTN_PRESS_DOWN) | FSM_EV(BTN_PRESS_REPEAT), FSM_TICKS_RESET | FSM_REPEAT_INC },
+		  { BTN_STATE_REPEAT, FSM_EV(BTN_PRESS_DOWN) | FSM_EV(BTN_PRESS_REPEAT), FSM_TICKS_RESET | FSM_REPEAT_INC } },
+	},
+	[BTN_STATE_REPEAT] = {
+		{ { BTN_STATE_RELEASE, FSM_EV(BTN_PRESS_UP), FSM_TICKS_RESET }, { BTN_STATE_IDLE, FSM_EV(BTN_PRESS_UP), 0 } },
+		{ { BTN_STATE_REPEAT, 0, 0 }, { BTN_STATE_PRESS, 0, FSM_TICKS_RESET | FSM_REPEAT_CLEAR } },
+	},
+	[BTN_STATE_LONG_HOLD] = {
+		{ { BTN_STATE_IDLE, FSM_EV(BTN_PRESS_UP), 0 }, { BTN_STATE_IDLE, FSM_EV(BTN_PRESS_UP), 0 } },
+		{ { BTN_STATE_LONG_HOLD, FSM_EV(BTN_LONG_PRESS_HOLD), 0 }, { BTN_STATE_LONG_HOLD, FSM_EV(BTN_LONG_PRESS_HOLD), 0 } },
+	},
+};
+
+/**
+  * @brief  State machine transition, the tick already counted
+  *         Table-driven variant: one lookup by (state, pressed, timeout)
+  *         yields the next state, the events and the tick/repeat actions.
+  * @param  fsm: state machine working copy (ticks, state, repeat)
+  * @param  pressed: debounced level equals active level
+  * @param  profile: timing thresholds
+  * @retval mask of emitted events, BTN_EVENT_BIT(ev), lowest event first
+  */
+static inline uint8_t button_fsm_transition(ButtonFsm* fsm, uint8_t pressed, const ButtonProfile* profile)
+{
+	if (fsm->state >= FSM_STATE_COUNT) {
+		fsm->state = BTN_STATE_IDLE;  // Invalid state, reset to idle
+		return 0;
+	}
+
+	pressed = pressed ? 1 : 0;
+#ifdef MULTIBUTTON_TYPEMATIC
+	if (fsm->state == BTN_STATE_LONG_HOLD && pressed && profile->hold_interval) {
+		return button_hold_step(fsm, profile);  // typematic repeat instead of every tick
+	}
+#endif
+	uint8_t limit = button_fsm_limit[fsm->state][pressed];
+	uint16_t threshold = (limit & FSM_LIMIT_LONG) ? profile->long_ticks : profile->short_ticks;
+	uint8_t expired = limit && (fsm->ticks > threshold || ((limit & FSM_LIMIT_EQUAL) && fsm->ticks == threshold));
+
+	const ButtonFsmEntry* entry = &button_fsm_table[fsm->state][pressed][expired];
+	uint8_t events = entry->events;
+	uint8_t action = entry->action;
+
+	if (action) {
+		if (action & FSM_TICKS_RESET) {
+			fsm->ticks = 0;
+		}
+		if (action & FSM_REPEAT_SET) {
+			fsm->repeat = 1;
+		} else if (action & FSM_REPEAT_INC) {
+			if (fsm->repeat < PRESS_REPEAT_MAX_NUM) {
+				fsm->repeat++;
+			}
+		} else if (action & FSM_REPEAT_CLEAR) {
+			fsm->repeat = 0;
+		}
+		if (action & FSM_CLICK) {
+			// Timeout reached, determine click type
+			if (fsm->repeat == 1) {
+				events = BTN_EVENT_BIT(BTN_SINGLE_CLICK);
+			} else if (fsm->repeat == 2) {
+				events = BTN_EVENT_BIT(BTN_DOUBLE_CLICK);
+			}
+		}
+	}
+	fsm->state = entry->next;
+#ifdef MULTIBUTTON_TYPEMATIC
+	if ((events & BTN_EVENT_BIT(BTN_LONG_PRESS_START)) && profile->hold_interval) {
+		fsm->ticks = 0;   // typematic: count ticks and repeats from the long press start
+		fsm->hold = 0;
+	}
+#endif
+
+	return events;
+}
+#else
+/**
+  * @brief  State machine transition, the tick already counted
+  *         Works on a local copy of the hot state so it can be fed from
+  *         either a Button struct or the parallel arrays of a ButtonPool.
+  * @param  fsm: state machine working copy (ticks, state, repeat)
+  * @param  pressed: debounced level equals active level
+  * @param  profile: timing thresholds
+  * @retval mask of emitted events, BTN_EVENT_BIT(ev), lowest event first
+  */
+static inline uint8_t button_fsm_transition(ButtonFsm* fsm, uint8_t pressed, const ButtonProfile* profile)
+{
+	uint8_t events = 0;
+
+	switch (fsm->state) {
+	case BTN_STATE_IDLE:
+		if (pressed) {
+			// Button press detected
+			events = BTN_EVENT_BIT(BTN_PRESS_DOWN);
+			fsm->ticks = 0;
+			fsm->repeat = 1;
+			fsm->state = BTN_STATE_PRESS;
+		}
+		break;
+
+	case BTN_STATE_PRESS:
+		if (!pressed) {
+			// Button released
+			events = BTN_EVENT_BIT(BTN_PRESS_UP);
+			fsm->ticks = 0;
+			fsm->state = BTN_STATE_RELEASE;
+		} else if (fsm->ticks > profile->long_ticks) {
+			// Long press detected
+			events = BTN_EVENT_BIT(BTN_LONG_PRESS_START);
+			fsm->state = BTN_STATE_LONG_HOLD;
+#ifdef MULTIBUTTON_TYPEMATIC
+			if (profile->hold_interval) {
+				fsm->ticks = 0;   // typematic: count ticks and repeats from the long press start
+				fsm->hold = 0;
+			}
+#endif
+		}
+		break;
+
+	case BTN_STATE_RELEASE:
+		if (pressed) {
+			// Button pressed again
+			events = BTN_EVENT_BIT(BTN_PRESS_DOWN) | BTN_EVENT_BIT(BTN_PRESS_REPEAT);
+			if (fsm->repeat < PRESS_REPEAT_MAX_NUM) {
+				fsm->repeat++;
+			}
+			fsm->ticks = 0;
+			fsm->state = BTN_STATE_REPEAT;
+		} else if (fsm->ticks > profile->short_ticks) {
+			// Timeout reached, determine click type
+			if (fsm->repeat == 1) {
+				events = BTN_EVENT_BIT(BTN_SINGLE_CLICK);
+			} else if (fsm->repeat == 2) {
+				events = BTN_EVENT_BIT(BTN_DOUBLE_CLICK);
+			}
+			fsm->state = BTN_STATE_IDLE;
+		}
+		break;
+
+	case BTN_STATE_REPEAT:
+		if (!pressed) {
+			// Button released
+			events = BTN_EVENT_BIT(BTN_PRESS_UP);
+			if (fsm->ticks < profile->short_ticks) {
+				fsm->ticks = 0;
+				fsm->state = BTN_STATE_RELEASE;  // Continue waiting for more presses
+			} else {
+				fsm->state = BTN_STATE_IDLE;  // End of sequence
+			}
+		} else if (fsm->ticks > profile->short_ticks) {
+			// Held down too long, treat as normal press
+			fsm->ticks = 0;      // reset for fresh long-press timing
+			fsm->repeat = 0;     // clear repeat count for new press cycle
+			fsm->state = BTN_STATE_PRESS;
+		}
+		break;
+
+	case BTN_STATE_LONG_HOLD:
+		if (pressed) {
+			// Continue holding: every tick, or at the typematic repeat instants
+#ifdef MULTIBUTTON_TYPEMATIC
+			events = profile->hold_interval ? button_hold_step(fsm, profile) : BTN_EVENT_BIT(BTN_LONG_PRESS_HOLD);
+#else
+			events = BTN_EVENT_BIT(BTN_LONG_PRESS_HOLD);
+#endif
+		} else {
+			// Released from long press
+			events = BTN_EVENT_BIT(BTN_PRESS_UP);
+			fsm->state = BTN_STATE_IDLE;
+		}
+		break;
+
+	default:
+		// Invalid state, reset to idle
+		fsm->state = BTN_STATE_IDLE;
+		break;
+	}
+
+	return events;
+}
+#endif
+
+/**
+  * @brief  Count one tick of a state machine that is not idle
+  * @param  fsm: state machine working copy
+  * @retval None
+  */
+static inline void button_fsm_count(ButtonFsm* fsm)
+{
+	// Increment ticks counter when not in idle state (with saturation)
+	if (fsm->state > BTN_STATE_IDLE) {
+		if (fsm->ticks < UINT16_MAX) {
+			fsm->ticks++;
+		}
+	}
+}
+
+/**
+  * @brief  State machine core shared by list buttons and button pools:
+  *         count the tick, then take the transition
+  * @param  fsm: state machine working copy (ticks, state, repeat)
+  * @param  pressed: debounced level equals active level
+  * @param  profile: timing thresholds
+  * @retval mask of emitted events, BTN_EVENT_BIT(ev), lowest event first
+  */
+static inline uint8_t button_fsm_step(ButtonFsm* fsm, uint8_t pressed, const ButtonProfile* profile)
+{
+	button_fsm_count(fsm);
+	return button_fsm_transition(fsm, pressed, profile);
+}
+
+/**
+  * @brief  Number of state machine steps until the next time-based transition
+  *         With unchanged input, the first (deadline - 1) steps only count ticks.
+  * @param  fsm: state machine working copy
+  * @param  pressed: debounced level equals active level
+  * @retval steps until the next transition, BUTTON_DEADLINE_NONE if none pending
+  */
+static inline uint16_t button_fsm_deadline(const ButtonFsm* fsm, uint8_t pressed, const ButtonProfile* profile)
+{
+	uint16_t limit;
+
+	switch (fsm->state) {
+	case BTN_STATE_IDLE:
+		return pressed ? 1 : BUTTON_DEADLINE_NONE;
+	case BTN_STATE_PRESS:
+		if (!pressed) return 1;
+		limit = profile->long_ticks;
+		break;
+	case BTN_STATE_RELEASE:
+		if (pressed) return 1;
+		limit = profile->short_ticks;
+		break;
+	case BTN_STATE_REPEAT:
+		if (!pressed) return 1;
+		limit = profile->short_ticks;
+		break;
+	case BTN_STATE_LONG_HOLD:
+#ifdef MULTIBUTTON_TYPEMATIC
+		if (pressed && profile->hold_interval) {
+			// Typematic repeat once ticks reaches the wait
+			uint16_t wait = button_hold_wait(fsm, profile);
+			return (fsm->ticks >= wait) ? 1 : (uint16_t)(wait - fsm->ticks);
+		}
+#endif
+		return 1;  // BTN_LONG_PRESS_HOLD fires every tick
+	default:
+		return 1;
+	}
+
+	// Each step increments ticks before comparing against the threshold
+	return (fsm->ticks >= limit) ? 1 : (uint16_t)(limit - fsm->ticks + 1);
+}
+
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+/**
+  * @brief  Queue an event for deferred dispatch (producer side)
+  * @param  group: the group whose queue receives the event
+  * @param  source: the button handle struct, or the chord for QUEUED_CHORD events
+  * @param  event: event to queue
+  * @retval None
+  */
+static inline void button_queue_push(ButtonGroup* group, void* source, uint8_t event)
+{
+	uint16_t head = group->queue_head;
+
+	if ((uint16_t)(head - group->queue_tail) >= MULTIBUTTON_EVENT_QUEUE_SIZE) {
+		group->queue_overflow++;  // queue full, drop the event
+		return;
+	}
+	group->queue_buf[head & (MULTIBUTTON_EVENT_QUEUE_SIZE - 1)].source = source;
+	group->queue_buf[head & (MULTIBUTTON_EVENT_QUEUE_SIZE - 1)].event = event;
+	MULTIBUTTON_BARRIER();  // record visible before publishing it
+	group->queue_head = (uint16_t)(head + 1);
+}
+
+/**
+  * @brief  Run the callbacks of all events queued by a group (consumer side)
+  *         Call from the main loop; callbacks run in the caller's context.
+  * @param  group: the group struct
+  * @retval number of events dispatched
+  */
+BUTTON_GROUP_API uint16_t button_group_dispatch_pending(ButtonGroup* group)
+{
+	if (!group) return 0;  // parameter validation
+
+	uint16_t tail = group->queue_tail;
+	uint16_t count = 0;
+
+	while (tail != group->queue_head) {
+		MULTIBUTTON_BARRIER();  // read the record after seeing it published
+		ButtonQueued rec = group->queue_buf[tail & (MULTIBUTTON_EVENT_QUEUE_SIZE - 1)];
+		MULTIBUTTON_BARRIER();  // record copied before releasing the slot
+		group->queue_tail = ++tail;
+
+		Button* handle = (Button*)rec.source;
+#ifdef MULTIBUTTON_CHORDS
+		if (rec.event & QUEUED_CHORD) {
+			ButtonChord* chord = (ButtonChord*)rec.source;
+			BtnChordCallback cb = chord->cb[rec.event & QUEUED_INDEX_MASK];
+			if (cb) {
+				cb(chord, chord->user_data);
+			}
+			count++;
+			continue;
+		}
+#endif
+#ifdef MULTIBUTTON_GESTURES
+		if (rec.event & QUEUED_GESTURE) {
+			// Gesture table may have been replaced meanwhile
+			const ButtonGesture* g = handle->gestures;
+			uint8_t index = rec.event & QUEUED_INDEX_MASK;
+			while (g && g->presses && index) {
+				g++;
+				index--;
+			}
+			if (g && g->presses && g->cb) {
+				g->cb(handle, BUTTON_USER_DATA(handle));
+			}
+			count++;
+			continue;
+		}
+#endif
+		// button_get_dispatched_event() reports the queued event to the callback
+		group->queue_source = handle;
+		group->queue_event = rec.event;
+		EVENT_CB(rec.event);  // callback may have been detached meanwhile
+		group->queue_source = NULL;
+		count++;
+	}
+	return count;
+}
+
+/**
+  * @brief  Run the callbacks of all queued events of the default group
+  * @param  None
+  * @retval number of events dispatched
+  */
+uint16_t button_dispatch_pending(void)
+{
+	return button_group_dispatch_pending(&group_default);
+}
+
+/**
+  * @brief  Get the number of events a group dropped because its queue was full
+  * @param  group: the group struct
+  * @retval overflow counter
+  */
+BUTTON_GROUP_API uint32_t button_group_queue_overflows(ButtonGroup* group)
+{
+	return group ? group->queue_overflow : 0;
+}
+
+/**
+  * @brief  Get the number of events dropped because the queue was full
+  * @param  None
+  * @retval overflow counter
+  */
+uint32_t button_queue_overflows(void)
+{
+	return button_group_queue_overflows(&group_default);
+}
+#endif
+
+#if MULTIBUTTON_BATCH_SIZE > 0
+/**
+  * @brief  Set the sink receiving all events of a group's tick in one call
+  * @param  group: the group struct
+  * @param  sink: batch sink, NULL to disable
+  * @param  user_data: user context pointer passed to the sink
+  * @retval None
+  */
+BUTTON_GROUP_API void button_group_set_batch_sink(ButtonGroup* group, BtnBatchSink sink, void* user_data)
+{
+	if (!group) return;  // parameter validation
+
+	group->batch_sink = sink;
+	group->batch_user_data = user_data;
+	group->batch_count = 0;
+}
+
+/**
+  * @brief  Set the sink receiving all events of a tick in one call
+  * @param  sink: batch sink, NULL to disable
+  * @param  user_data: user context pointer passed to the sink
+  * @retval None
+  */
+void button_set_batch_sink(BtnBatchSink sink, void* user_data)
+{
+	button_group_set_batch_sink(&group_default, sink, user_data);
+}
+
+/**
+  * @brief  Deliver the collected events to the batch sink
+  * @param  group: the group whose batch is delivered
+  * @retval None
+  */
+static void button_batch_flush(ButtonGroup* group)
+{
+	if (group->batch_count && group->batch_sink) {
+		uint16_t count = group->batch_count;
+		group->batch_count = 0;  // sink may trigger new events
+		group->batch_sink(group->batch_buf, count, group->batch_user_data);
+	}
+}
+
+/**
+  * @brief  Append an event to the current batch of the button's group
+  * @param  handle: the button handle struct
+  * @param  event: emitted event
+  * @param  repeat: repeat counter after the transition
+  * @retval None
+  */
+static inline void button_batch_push(Button* handle, uint8_t event, uint8_t repeat)
+{
+	ButtonGroup* group = BUTTON_GROUP(handle);
+
+	if (group->batch_count >= MULTIBUTTON_BATCH_SIZE) {
+		button_batch_flush(group);  // buffer full, deliver early
+	}
+	group->batch_buf[group->batch_count].button_id = handle->button_id;
+	group->batch_buf[group->batch_count].event = event;
+	group->batch_buf[group->batch_count].repeat = repeat;
+	group->batch_count++;
+}
+#endif
+
+#ifdef MULTIBUTTON_GESTURES
+/**
+  * @brief  Fire the first gesture of a button matching a finished press sequence
+  * @param  handle: the button handle struct (gestures set)
+  * @param  presses: presses in the sequence
+  * @param  hold: last press reached the long press threshold
+  * @retval None
+  */
+static void button_gesture_match(Button* handle, uint8_t presses, uint8_t hold)
+{
+	for (const ButtonGesture* g = handle->gestures; g->presses; g++) {
+		if (g->presses == presses && !g->hold == !hold) {
+			if (g->cb) {
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+				uint32_t index = (uint32_t)(g - handle->gestures);
+				if (index <= QUEUED_INDEX_MASK) {
+					button_queue_push(BUTTON_GROUP(handle), handle, (uint8_t)(QUEUED_GESTURE | index));
+				}
+#else
+				g->cb(handle, BUTTON_USER_DATA(handle));
+#endif
+			}
+			return;
+		}
+	}
+}
+#endif
+
+#if MULTIBUTTON_TRACE_SIZE > 0
+/**
+  * @brief  Record a state machine transition, one record per emitted event
+  * @param  handle: the button handle struct
+  * @param  old_state: state before the step
+  * @param  new_state: state after the step
+  * @param  events: event mask returned by button_fsm_transition()
+  * @retval None
+  */
+static void button_trace(Button* handle, uint8_t old_state, uint8_t new_state, uint8_t events)
+{
+	ButtonGroup* group = BUTTON_GROUP(handle);
+	uint8_t ev = 0;
+
+	do {
+		if (!events || (events & 1U)) {
+			group->trace_buf[group->trace_head++ & (MULTIBUTTON_TRACE_SIZE - 1)] = BUTTON_TRACE_PACK(group->trace_tick,
+				handle->button_id, old_state, new_state, events ? ev : BUTTON_TRACE_NO_EVENT);
+		}
+		ev++;
+		events >>= 1;
+	} while (events);
+}
+
+/**
+  * @brief  Copy the transitions recorded by a group, oldest first
+  * @param  group: the group struct
+  * @param  out: destination array
+  * @param  max: capacity of out
+  * @retval number of records copied (the newest ones if max is smaller than the ring)
+  */
+BUTTON_GROUP_API uint16_t button_group_trace_dump(ButtonGroup* group, uint32_t* out, uint16_t max)
+{
+	if (!group || !out) return 0;  // parameter validation
+
+	uint32_t head = group->trace_head;
+	uint32_t count = (head < MULTIBUTTON_TRACE_SIZE) ? head : MULTIBUTTON_TRACE_SIZE;
+	if (count > max) {
+		count = max;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		out[i] = group->trace_buf[(head - count + i) & (MULTIBUTTON_TRACE_SIZE - 1)];
+	}
+	return (uint16_t)count;
+}
+
+/**
+  * @brief  Copy the recorded transitions of the default group, oldest first
+  * @param  out: destination array
+  * @param  max: capacity of out
+  * @retval number of records copied
+  */
+uint16_t button_trace_dump(uint32_t* out, uint16_t max)
+{
+	return button_group_trace_dump(&group_default, out, max);
+}
+
+/**
+  * @brief  Discard all transitions recorded by a group
+  * @param  group: the group struct
+  * @retval None
+  */
+BUTTON_GROUP_API void button_group_trace_clear(ButtonGroup* group)
+{
+	if (!group) return;  // parameter validation
+
+	group->trace_head = 0;
+}
+
+/**
+  * @brief  Discard all recorded transitions of the default group
+  * @param  None
+  * @retval None
+  */
+void button_trace_clear(void)
+{
+	button_group_trace_clear(&group_default);
+}
+#endif
+
+/**
+  * @brief  Dispatch the events emitted by one state machine step, then
+  *         store the new state. Callbacks run in the order of the original
+  *         handler: they see the state before the transition with this
+  *         tick counted, and BTN_PRESS_REPEAT sees the incremented repeat.
+  * @param  handle: the button handle struct (ticks already counted)
+  * @param  fsm: state after the transition
+  * @param  events: event mask returned by button_fsm_transition()
+  * @retval None
+  */
+static void button_dispatch(Button* handle, const ButtonFsm* fsm, uint8_t events)
+{
+	uint8_t old_state = handle->state;
+
+#if MULTIBUTTON_TRACE_SIZE > 0
+	if (old_state != fsm->state || (events & ~BTN_EVENT_BIT(BTN_LONG_PRESS_HOLD))) {
+		button_trace(handle, old_state, fsm->state, events);
+	}
+#endif
+#ifdef MULTIBUTTON_CHORDS
+	ButtonGroup* group = BUTTON_GROUP(handle);
+	if (group->chord_suppressed && handle->button_id < 32 &&
+	    (group->chord_suppressed & (1UL << handle->button_id))) {
+		// Member of a formed chord: individual events are swallowed until it is idle again
+		handle->event = (uint8_t)BTN_NONE_PRESS;
+		if (fsm->state == BTN_STATE_IDLE) {
+			group->chord_suppressed &= ~(1UL << handle->button_id);
+		}
+		button_fsm_store(handle, fsm);
+		return;
+	}
+#endif
+
+	if (!events) {
+		// Idle without press reports no event for polling mode
+		if (old_state == BTN_STATE_IDLE) {
+			handle->event = (uint8_t)BTN_NONE_PRESS;
+		}
+	} else {
+		uint8_t subscribed = handle->cb_mask;
+
+#ifdef MULTIBUTTON_GESTURES
+		if (events & BTN_EVENT_BIT(BTN_PRESS_DOWN)) {
+			handle->seq = fsm->repeat;  // repeat is cleared when a repeat press is held
+		}
+#endif
+		for (uint8_t ev = 0, rest = events; rest; ev++, rest >>= 1) {
+			if (!(rest & 1U)) continue;
+
+			if (ev == BTN_PRESS_REPEAT) {
+				handle->repeat = fsm->repeat;  // counted between PRESS_DOWN and PRESS_REPEAT
+			}
+#ifdef MULTIBUTTON_STATS
+			STATS_INC(handle->stats.events[ev]);
+#endif
+#if MULTIBUTTON_BATCH_SIZE > 0
+			if (BUTTON_GROUP(handle)->batch_sink) {
+				button_batch_push(handle, ev, fsm->repeat);
+			}
+#endif
+			// Polling reports the last emitted event, callbacks their own one
+			handle->event = ev;
+			if (subscribed & BTN_EVENT_BIT(ev)) {
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+				button_queue_push(BUTTON_GROUP(handle), handle, ev);
+#else
+				EVENT_CALL(ev);
+#endif
+			}
+		}
+	}
+
+	button_fsm_store(handle, fsm);
+
+#ifdef MULTIBUTTON_GESTURES
+	if (handle->gestures) {
+		if (events & BTN_EVENT_BIT(BTN_LONG_PRESS_START)) {
+			button_gesture_match(handle, handle->seq, 1);
+		} else if (old_state == BTN_STATE_RELEASE && fsm->state == BTN_STATE_IDLE) {
+			button_gesture_match(handle, fsm->repeat, 0);  // click timeout
+		}
+	}
+#endif
+}
+
+/**
+  * @brief  Button driver core function, driver state machine
+  * @param  handle: the button handle struct
+  * @retval None
+  */
+static void button_handler(Button* handle)
+{
+	button_debounce(handle);
+	button_step(handle);
+}
+
+/**
+  * @brief  Sample and debounce the input of a polled button
+  * @param  handle: the button handle struct
+  * @retval None
+  */
+static void button_debounce(Button* handle)
+{
+	uint8_t read_gpio_level = button_read_level(handle);
+
+	/* Button debounce handling */
+	if (handle->input == BTN_INPUT_PORT) {
+		// Port words are debounced bit-sliced in button_read_level()
+		handle->button_level = read_gpio_level;
+#if defined(MULTIBUTTON_STATS) && MULTIBUTTON_MAX_PORTS > 0
+		if (BUTTON_GROUP(handle)->port_rejected[handle->port] & handle->pin_mask) {
+			STATS_INC(handle->stats.bounces);
+		}
+#endif
+	} else if (read_gpio_level != handle->button_level) {
+		// Continue reading same new level for debounce
+		if (++(handle->debounce_cnt) >= BUTTON_PROFILE(handle)->debounce_ticks) {
+			handle->button_level = read_gpio_level;
+			handle->debounce_cnt = 0;
+		}
+	} else {
+		// Level not changed, reset counter
+#ifdef MULTIBUTTON_STATS
+		if (handle->debounce_cnt) {
+			STATS_INC(handle->stats.bounces);
+		}
+#endif
+		handle->debounce_cnt = 0;
+	}
+}
+
+/**
+  * @brief  Run one state machine step on the debounced level and dispatch its events
+  * @param  handle: the button handle struct
+  * @retval None
+  */
+static void button_step(Button* handle)
+{
+	// Fast path: idle and released, no transition and nothing to dispatch
+	if (handle->state == BTN_STATE_IDLE && handle->button_level != handle->active_level) {
+		handle->event = (uint8_t)BTN_NONE_PRESS;
+		return;
+	}
+
+	ButtonFsm fsm = button_fsm_load(handle);
+
+	button_fsm_count(&fsm);
+	handle->ticks = fsm.ticks;
+	button_dispatch(handle, &fsm, button_fsm_transition(&fsm, handle->button_level == handle->active_level, BUTTON_PROFILE(handle)));
+}
+
+#ifdef MULTIBUTTON_TIME_DRIVEN
+/**
+  * @brief  Run state machine steps with unchanged debounced input
+  *         Steps that can only count ticks are skipped in one go; long press
+  *         hold fires once per call when several ticks are coalesced, or at
+  *         each typematic repeat instant.
+  * @param  handle: the button handle struct
+  * @param  count: number of ticks to run
+  * @retval None
+  */
+static void button_run_ticks(Button* handle, uint32_t count)
+{
+	uint8_t pressed = (handle->button_level == handle->active_level);
+
+	while (count) {
+		ButtonFsm fsm = button_fsm_load(handle);
+		uint32_t step = (fsm.state == BTN_STATE_LONG_HOLD && !BUTTON_TYPEMATIC(BUTTON_PROFILE(handle))) ?
+			count : button_fsm_deadline(&fsm, pressed, BUTTON_PROFILE(handle));
+
+		if (step > count) {
+			step = count;
+		}
+		// The first (step - 1) ticks only advance the counter
+		if (fsm.state > BTN_STATE_IDLE) {
+			uint32_t ticks = fsm.ticks + step - 1;
+			fsm.ticks = (ticks < UINT16_MAX) ? (uint16_t)ticks : UINT16_MAX;
+		}
+
+		button_fsm_count(&fsm);
+		handle->ticks = fsm.ticks;
+		button_dispatch(handle, &fsm, button_fsm_transition(&fsm, pressed, BUTTON_PROFILE(handle)));
+		count -= step;
+	}
+}
+
+/**
+  * @brief  Debounce window of a time-driven button, DEBOUNCE_MS of its profile
+  * @param  handle: the button handle struct
+  * @retval window in milliseconds
+  */
+static inline uint32_t button_edge_window(Button* handle)
+{
+	uint8_t depth = BUTTON_PROFILE(handle)->debounce_ticks;
+	return (depth > 1) ? (uint32_t)(depth - 1) * TICKS_INTERVAL : 0;
+}
+
+/**
+  * @brief  Ticks until the pending level change of a time-driven button
+  *         has been stable for the debounce window
+  * @param  handle: the button handle struct (edge_pending set)
+  * @retval ticks after stamp_ms at which the new level is accepted (>= 1)
+  */
+static inline uint32_t button_edge_commit(Button* handle)
+{
+	int32_t wait = (int32_t)(handle->edge_ms + button_edge_window(handle) - handle->stamp_ms);
+	return (wait <= 0) ? 1 : ((uint32_t)wait + TICKS_INTERVAL - 1) / TICKS_INTERVAL;
+}
+
+/**
+  * @brief  Check whether a time-driven button has nothing to time: idle,
+  *         released and no level change pending
+  * @param  handle: the button handle struct
+  * @retval 1: ticks would not change it, 0: otherwise
+  */
+static inline uint8_t button_time_idle(const Button* handle)
+{
+	return handle->state == BTN_STATE_IDLE && !handle->edge_pending &&
+	       handle->button_level != handle->active_level;
+}
+
+/**
+  * @brief  Move the last tick of an idle time-driven button next to a timestamp
+  *         Nothing is timed while idle, so a gap of any length, even 2^31 ms
+  *         or more, is elapsed time rather than a stale timestamp. This also
+  *         seeds the stamp on the first call after initialization.
+  * @param  handle: the button handle struct (idle, see button_time_idle())
+  * @param  now_ms: monotonic timestamp in milliseconds
+  * @retval None
+  */
+static inline void button_time_snap(Button* handle, uint32_t now_ms)
+{
+	uint32_t gap = now_ms - handle->stamp_ms;
+
+	if (gap >= TICKS_INTERVAL) {
+		handle->stamp_ms = now_ms - gap % TICKS_INTERVAL;  // same grid, last tick at or before now_ms
+		handle->event = (uint8_t)BTN_NONE_PRESS;           // what the skipped idle ticks report
+	}
+}
+
+/**
+  * @brief  Advance a time-driven button to a timestamp
+  *         Processes every tick on the TICKS_INTERVAL grid up to now_ms,
+  *         accepting a pending level change at the tick its debounce window ends.
+  * @param  handle: the button handle struct
+  * @param  now_ms: monotonic timestamp in milliseconds
+  * @retval None
+  */
+static void button_advance(Button* handle, uint32_t now_ms)
+{
+	if (button_time_idle(handle)) {
+		button_time_snap(handle, now_ms);
+		return;
+	}
+	if ((int32_t)(now_ms - handle->stamp_ms) < TICKS_INTERVAL) return;  // no tick due (or stale timestamp)
+
+	uint32_t due = (now_ms - handle->stamp_ms) / TICKS_INTERVAL;
+	uint32_t left = due;
+
+	if (handle->edge_pending) {
+		uint32_t commit = button_edge_commit(handle);
+		if (commit <= left) {
+			if (commit > 1) {
+				button_run_ticks(handle, commit - 1);
+			}
+			handle->button_level = !handle->button_level;
+			handle->edge_pending = 0;
+			button_run_ticks(handle, 1);
+			left -= commit;
+		}
+	}
+	if (left) {
+		button_run_ticks(handle, left);
+	}
+	handle->stamp_ms += due * TICKS_INTERVAL;
+}
+
+/**
+  * @brief  Feed a raw level observed at a timestamp into the time-window debounce
+  * @param  handle: the button handle struct
+  * @param  level: raw GPIO level
+  * @param  timestamp_ms: time the level was observed
+  * @retval None
+  */
+static inline void button_feed(Button* handle, uint8_t level, uint32_t timestamp_ms)
+{
+	if ((level ? 1 : 0) != handle->button_level) {
+		// Keep the first time the new level was seen
+		if (!handle->edge_pending) {
+			handle->edge_pending = 1;
+			handle->edge_ms = timestamp_ms;
+		}
+	} else {
+		// Bounced back before the window ended
+#ifdef MULTIBUTTON_STATS
+		if (handle->edge_pending) {
+			STATS_INC(handle->stats.bounces);
+		}
+#endif
+		handle->edge_pending = 0;
+	}
+}
+
+/**
+  * @brief  Sample the level of a polled button at a timestamp
+  *         Ticks missed since the previous call are run with the previously
+  *         accepted level. The new sample is fed first: a pending level
+  *         change is only accepted when a sample taken at least the debounce
+  *         window after it was first seen still shows it, so a glitch seen
+  *         by a single sample is rejected at any call rate. The tick taking
+  *         the sample is left to the caller.
+  * @param  handle: the button handle struct (pin or port input)
+  * @param  now_ms: monotonic timestamp in milliseconds
+  * @retval 1: the level is sampled and the tick at stamp_ms + TICKS_INTERVAL is due, 0: no tick due
+  */
+static uint8_t button_sample_level(Button* handle, uint32_t now_ms)
+{
+	if (button_time_idle(handle) && now_ms - handle->stamp_ms >= TICKS_INTERVAL) {
+		button_time_snap(handle, now_ms);
+		handle->stamp_ms -= TICKS_INTERVAL;  // only the last tick takes the new sample
+	}
+	if ((int32_t)(now_ms - handle->stamp_ms) < TICKS_INTERVAL) return 0;  // no tick due (or stale timestamp)
+
+	uint32_t due = (now_ms - handle->stamp_ms) / TICKS_INTERVAL;
+
+	if (due > 1) {
+		button_run_ticks(handle, due - 1);
+		handle->stamp_ms += (due - 1) * TICKS_INTERVAL;
+	}
+
+	uint32_t at = handle->stamp_ms + TICKS_INTERVAL;
+	button_feed(handle, button_read_raw(handle), at);
+	if (handle->edge_pending && at - handle->edge_ms >= button_edge_window(handle)) {
+		handle->button_level = !handle->button_level;
+		handle->edge_pending = 0;
+	}
+	return 1;
+}
+
+/**
+  * @brief  Sample a polled button at a timestamp, see button_sample_level()
+  * @param  handle: the button handle struct (pin or port input)
+  * @param  now_ms: monotonic timestamp in milliseconds
+  * @retval None
+  */
+static void button_sample_at(Button* handle, uint32_t now_ms)
+{
+	if (button_sample_level(handle, now_ms)) {
+		handle->stamp_ms += TICKS_INTERVAL;
+		button_run_ticks(handle, 1);
+	}
+}
+
+/**
+  * @brief  Report a level change of an edge-driven button
+  *         Call from the GPIO interrupt on both edges. The state machine is
+  *         first advanced to timestamp_ms, then the new level starts its
+  *         debounce window; bouncing back cancels it.
+  * @param  handle: the button handle struct (initialized with button_init_edge())
+  * @param  level: GPIO level after the edge
+  * @param  timestamp_ms: monotonic timestamp of the edge in milliseconds
+  * @retval None
+  */
+void button_on_edge(Button* handle, uint8_t level, uint32_t timestamp_ms)
+{
+	if (!handle || handle->input != BTN_INPUT_EDGE) return;  // parameter validation
+
+#if MULTIBUTTON_TRACE_SIZE > 0
+	BUTTON_GROUP(handle)->trace_tick = (uint16_t)(timestamp_ms / TICKS_INTERVAL);
+#endif
+	button_advance(handle, timestamp_ms);
+	button_feed(handle, level, timestamp_ms);
+#if MULTIBUTTON_BATCH_SIZE > 0
+	button_batch_flush(BUTTON_GROUP(handle));
+#endif
+}
+#endif
+
+/**
+  * @brief  Find the next button to visit in the current tick pass
+  *         The list is walked without the lock. button_stop() keeps the
+  *         stopped button's next link, so a pass standing on it carries on
+  *         into the list; stopped buttons are skipped. The pass reads the
+  *         successor before a button's callbacks run, so they may stop,
+  *         reinitialize, restart or move their own button. A button restarted
+  *         during the pass links back to the head: its epoch mark keeps
+  *         the pass from visiting it or the buttons behind it twice. A
+  *         button restarted in another group links into that group's list,
+  *         so the pass goes back to its own head instead of following it.
+  * @param  group: the group being ticked
+  * @param  handle: candidate button, the successor of the previous one
+  * @retval button to visit, NULL at the end of the list
+  */
+static Button* button_list_next(ButtonGroup* group, Button* handle)
+{
+	while (handle) {
+		if (BUTTON_GROUP(handle) != group) {
+			handle = BUTTON_LINK(group->head);  // moved away, visited buttons are skipped
+		} else if (handle->epoch == group->epoch || !BUTTON_LINKED(handle)) {
+			handle = BUTTON_LINK(handle->next);
+		} else {
+			break;
+		}
+	}
+	if (handle) {
+		handle->epoch = group->epoch;
+	}
+	return handle;
+}
+
+#ifdef MULTIBUTTON_TIME_DRIVEN
+/**
+  * @brief  One time-based pass over a group, see button_group_ticks_at()
+  * @param  group: the group struct
+  * @param  now_ms: monotonic timestamp in milliseconds
+  * @param  interval: if not NULL, lowered to the recommended period of
+  *         the buttons just advanced, see button_group_ticks_elapsed()
+  * @retval None
+  */
+static void button_group_pass_at(ButtonGroup* group, uint32_t now_ms, uint16_t* interval)
+{
+#ifdef MULTIBUTTON_STATS
+	uint32_t tick_start = MULTIBUTTON_CYCLES();
+#endif
+#if MULTIBUTTON_TRACE_SIZE > 0
+	group->trace_tick = (uint16_t)(now_ms / TICKS_INTERVAL);
+#endif
+#if MULTIBUTTON_MAX_PORTS > 0
+	group->port_sampled = 0;  // invalidate port cache, ports are read lazily this call
+#endif
+
+	BUTTON_PASS_BEGIN(group);
+#ifdef MULTIBUTTON_CHORDS
+	uint8_t chorded = (group->chords != NULL);
+	if (chorded) {
+		// Sample every polled button first so chords see this call's levels before any member event
+		uint32_t pressed = 0;
+		uint32_t ticks = 0;
+		group->epoch++;
+		for (Button* b = button_list_next(group, BUTTON_LINK(group->head)); b;
+		     b = button_list_next(group, BUTTON_LINK(b->next))) {
+			if (b->input != BTN_INPUT_EDGE) {
+				button_sample_level(b, now_ms);  // runs missed ticks, the sampled one is run below
+			}
+			if (b->button_id < 32 && b->button_level == b->active_level) {
+				pressed |= 1UL << b->button_id;
+			}
+		}
+		if ((int32_t)(now_ms - group->chord_ms) >= TICKS_INTERVAL) {
+			ticks = (now_ms - group->chord_ms) / TICKS_INTERVAL;
+			group->chord_ms += ticks * TICKS_INTERVAL;
+		}
+		button_chord_eval(group, pressed, ticks);
+	}
+#endif
+
+	Button* next;
+	group->epoch++;
+	for (Button* target = button_list_next(group, BUTTON_LINK(group->head)); target;
+	     target = button_list_next(group, next)) {
+		next = BUTTON_LINK(target->next);  // before the callbacks can stop or relink target
+		if (target->input == BTN_INPUT_EDGE) {
+			button_advance(target, now_ms);
+#ifdef MULTIBUTTON_CHORDS
+		} else if (chorded) {
+			if ((int32_t)(now_ms - target->stamp_ms) >= TICKS_INTERVAL) {
+				target->stamp_ms += TICKS_INTERVAL;  // sampled in the chord pass
+				button_run_ticks(target, 1);
+			}
+#endif
+		} else {
+			button_sample_at(target, now_ms);
+		}
+		if (interval && *interval != TICKS_INTERVAL) {  // nothing shorter to find once polling
+			uint16_t d = button_deadline(target);
+			if (d == BUTTON_DEADLINE_NONE) continue;
+
+			if (target->input != BTN_INPUT_EDGE || d <= 1) {
+				*interval = TICKS_INTERVAL;  // polled inputs must be sampled every tick while active
+			} else if ((uint32_t)d * TICKS_INTERVAL < *interval) {
+				*interval = (uint16_t)(d * TICKS_INTERVAL);
+			}
+		}
+	}
+	BUTTON_PASS_END(group);
+#if MULTIBUTTON_BATCH_SIZE > 0
+	button_batch_flush(group);
+#endif
+#ifdef MULTIBUTTON_STATS
+	button_stats_tick(group, MULTIBUTTON_CYCLES() - tick_start);
+#endif
+}
+
+/**
+  * @brief  Time-based background ticks, an alternative to button_ticks()
+  *         Advances every button by the time elapsed since its last tick, so
+  *         it may be called late or at a jittery rate: missed periods are
+  *         coalesced and SHORT/LONG thresholds still use the elapsed time.
+  *         Polled buttons are sampled once per call and debounced with the
+  *         DEBOUNCE_MS window; edge-driven buttons only fire pending debounce
+  *         commits and timeouts. Do not mix with button_ticks() for the
+  *         same polled buttons.
+  * @param  group: the group struct
+  * @param  now_ms: monotonic timestamp in milliseconds
+  * @retval None
+  */
+BUTTON_GROUP_API void button_group_ticks_at(ButtonGroup* group, uint32_t now_ms)
+{
+	if (!group) return;  // parameter validation
+
+	button_group_pass_at(group, now_ms, NULL);
+}
+
+/**
+  * @brief  Time-based ticks of the default group, see button_group_ticks_at()
+  * @param  now_ms: monotonic timestamp in milliseconds
+  * @retval None
+  */
+void button_ticks_at(uint32_t now_ms)
+{
+	button_group_ticks_at(&group_default, now_ms);
+}
+
+/**
+  * @brief  Adaptive ticks of a group, an alternative to a fixed-period timer
+  *         Advances the group clock by elapsed_ms and ticks it like
+  *         button_group_ticks_at(), collecting each button's deadline in
+  *         the same pass without the lock. Returns how long the caller may wait
+  *         before the next call: MULTIBUTTON_IDLE_INTERVAL while every
+  *         button is idle and stable, TICKS_INTERVAL while a polled button
+  *         is pressed, debouncing or waiting for a timeout, and the time to
+  *         the next deadline of edge-driven buttons. Thresholds use elapsed
+  *         time, so timing is kept at any period; a press shorter than the
+  *         idle period may be missed by polled buttons.
+  * @param  group: the group struct
+  * @param  elapsed_ms: time since the previous call in milliseconds
+  * @retval recommended milliseconds until the next call
+  */
+BUTTON_GROUP_API uint16_t button_group_ticks_elapsed(ButtonGroup* group, uint32_t elapsed_ms)
+{
+	uint16_t interval = MULTIBUTTON_IDLE_INTERVAL;
+
+	if (!group) return interval;  // parameter validation
+
+	group->clock_ms += elapsed_ms;
+	button_group_pass_at(group, group->clock_ms, &interval);
+	return interval;
+}
+
+/**
+  * @brief  Adaptive ticks of the default group, see button_group_ticks_elapsed()
+  * @param  elapsed_ms: time since the previous call in milliseconds
+  * @retval recommended milliseconds until the next call
+  */
+uint16_t button_ticks_elapsed(uint32_t elapsed_ms)
+{
+	return button_group_ticks_elapsed(&group_default, elapsed_ms);
+}
+#endif
+
+/**
+  * @brief  Start the button work, add the handle into the work list of a group
+  *         Constant time in every build: membership is tracked by the
+  *         handle's pprev link (MULTIBUTTON_FAST_STOP) or linked flag, so
+  *         duplicates are rejected without a search. The handle is published
+  *         at the head after its links are set, so a tick walking the list
+  *         concurrently sees either list. A button
+  *         started during a tick pass takes part from the next pass. A
+  *         port-mapped button requests a seed of its pin in the group's
+  *         debounce state with its current level; the tick applies it.
+  * @param  group: the group struct
+  * @param  handle: target handle struct (initialized with button_init*())
+  * @retval 0: succeed, -1: already exist (in any group), -2: invalid parameter
+  */
+BUTTON_GROUP_API int button_group_start(ButtonGroup* group, Button* handle)
+{
+	if (!group || !handle) return -2;  // invalid parameter
+
+	MULTIBUTTON_LOCK();
+	if (BUTTON_LINKED(handle)) {
+		MULTIBUTTON_UNLOCK();
+		return -1;  // already exist
+	}
+
+#ifdef MULTIBUTTON_GROUPS
+	handle->group = group;
+#endif
+#if MULTIBUTTON_MAX_PORTS > 0
+	if (handle->input == BTN_INPUT_PORT) {
+		button_port_request_seed(group, handle);
+	}
+#endif
+	handle->next = group->head;
+	handle->epoch = group->epoch;  // already visited by a pass in progress
+#ifdef MULTIBUTTON_FAST_STOP
+	if (group->head) {
+		group->head->pprev = &handle->next;
+	}
+	handle->pprev = &group->head;
+#else
+	handle->linked = 1;
+#endif
+	MULTIBUTTON_BARRIER();  // links visible before publishing the handle
+	BUTTON_LINK(group->head) = handle;
+	MULTIBUTTON_UNLOCK();
+	return 0;
+}
+
+/**
+  * @brief  Start the button work in the default group
+  * @param  handle: target handle struct (initialized with button_init*())
+  * @retval 0: succeed, -1: already exist, -2: invalid parameter
+  */
+int button_start(Button* handle)
+{
+	return button_group_start(&group_default, handle);
+}
+
+/**
+  * @brief  Stop the button work, remove the handle from work list
+  *         Constant time only with MULTIBUTTON_FAST_STOP, which unlinks
+  *         through the handle's pprev link. By default the group's list is
+  *         searched for the predecessor under the lock, O(n) in the number of
+  *         started buttons. The handle's own next link is kept for a tick
+  *         pass standing on it.
+  * @param  handle: target handle struct
+  * @retval None
+  */
+void button_stop(Button* handle)
+{
+	if (!handle) return;  // parameter validation
+
+	MULTIBUTTON_LOCK();
+#ifdef MULTIBUTTON_FAST_STOP
+	if (handle->pprev) {
+		BUTTON_LINK(*handle->pprev) = handle->next;
+		if (handle->next) {
+			handle->next->pprev = handle->pprev;
+		}
+		handle->pprev = NULL;  // mark as not in list, next stays valid for the tick pass
+	}
+#else
+	if (handle->linked) {
+		Button** curr;
+		for (curr = &BUTTON_GROUP(handle)->head; *curr; curr = &(*curr)->next) {
+			if (*curr == handle) {
+				BUTTON_LINK(*curr) = handle->next;
+				break;
+			}
+		}
+		handle->linked = 0;  // mark as not in list, next stays valid for the tick pass
+	}
+#endif
+	MULTIBUTTON_UNLOCK();
+}
+
+#ifdef MULTIBUTTON_GROUPS
+/**
+  * @brief  Stop the button work if the handle was started in the given group
+  * @param  group: the group struct
+  * @param  handle: target handle struct
+  * @retval None
+  */
+void button_group_stop(ButtonGroup* group, Button* handle)
+{
+	if (!group || !handle || handle->group != group) return;  // parameter validation
+
+	button_stop(handle);
+}
+#endif
+
+/**
+  * @brief  Wait until a tick pass of a group running at the call has finished
+  *         A pass walks the list without the lock, so it may still stand on a
+  *         button or chord stopped by another thread. After this returns no
+  *         pass can reach them and their memory may be reused. Without
+  *         MULTIBUTTON_THREAD_SAFE ticks cannot overlap the caller and it
+  *         returns at once. Do not call from a callback or from a context
+  *         that preempts the tick: the pass it waits for cannot finish.
+  * @param  group: the group struct
+  * @retval None
+  */
+BUTTON_GROUP_API void button_group_synchronize(ButtonGroup* group)
+{
+	if (!group) return;  // parameter validation
+
+#ifdef MULTIBUTTON_THREAD_SAFE
+	MULTIBUTTON_BARRIER();  // unlink visible before sampling the pass counter
+	uint32_t passes = group->passes;
+	if (passes & 1U) {
+		while (group->passes == passes) {
+			MULTIBUTTON_RELAX();
+		}
+	}
+	MULTIBUTTON_BARRIER();
+#endif
+}
+
+/**
+  * @brief  Wait until a tick pass of the default group has finished, see button_group_synchronize()
+  * @param  None
+  * @retval None
+  */
+void button_synchronize(void)
+{
+	button_group_synchronize(&group_default);
+}
+
+#ifdef MULTIBUTTON_CHORDS
+/**
+  * @brief  Emit a chord event through its callback or the deferred queue
+  * @param  group: the group the chord belongs to
+  * @param  chord: the chord
+  * @param  event: chord event
+  * @retval None
+  */
+static void button_chord_emit(ButtonGroup* group, ButtonChord* chord, ButtonChordEvent event)
+{
+#if MULTIBUTTON_EVENT_QUEUE_SIZE == 0
+	(void)group;
+#endif
+	if (chord->cb[event]) {
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+		button_queue_push(group, chord, (uint8_t)(QUEUED_CHORD | event));
+#else
+		chord->cb[event](chord, chord->user_data);
+#endif
+	}
+}
+
+/**
+  * @brief  Next chord to evaluate in a tick pass, see button_list_next()
+  *         The chord list is walked without the lock like the button list:
+  *         a stopped chord keeps its next link and is skipped, the successor
+  *         is read before the chord's callbacks run, a restarted one is
+  *         marked visited, and a chord moved to another group sends
+  *         the pass back to its own head.
+  * @param  group: the group being ticked
+  * @param  chord: candidate chord, the successor of the previous one
+  * @retval chord to evaluate, NULL at the end of the list
+  */
+static ButtonChord* button_chord_next(ButtonGroup* group, ButtonChord* chord)
+{
+	while (chord) {
+		if (chord->group && chord->group != group) {
+			chord = BUTTON_CHORD_LINK(group->chords);  // moved away, visited chords are skipped
+		} else if (chord->epoch == group->epoch || !chord->group) {
+			chord = BUTTON_CHORD_LINK(chord->next);
+		} else {
+			break;
+		}
+	}
+	if (chord) {
+		chord->epoch = group->epoch;
+	}
+	return chord;
+}
+
+/**
+  * @brief  Long press threshold of a chord: the longest of its members' profiles
+  * @param  group: the group the chord is evaluated in
+  * @param  mask: member buttons, bit n = button_id n
+  * @retval threshold in ticks
+  */
+static uint16_t button_chord_long_ticks(ButtonGroup* group, uint32_t mask)
+{
+#ifdef MULTIBUTTON_PROFILES
+	uint16_t long_ticks = 0;
+
+	for (Button* b = BUTTON_LINK(group->head); b && BUTTON_GROUP(b) == group; b = BUTTON_LINK(b->next)) {
+		if (BUTTON_LINKED(b) && b->button_id < 32 && (mask & (1UL << b->button_id)) &&
+		    BUTTON_PROFILE(b)->long_ticks > long_ticks) {
+			long_ticks = BUTTON_PROFILE(b)->long_ticks;
+		}
+	}
+	return long_ticks;
+#else
+	(void)group;
+	(void)mask;
+	return button_profile_default.long_ticks;
+#endif
+}
+
+/**
+  * @brief  Evaluate all chords of a group against the pressed-state bitmap of this tick
+  * @param  group: the group being ticked
+  * @param  pressed: bit n set when the button with button_id n is pressed
+  * @param  ticks: ticks elapsed since the previous evaluation (coalesced by the time-driven passes)
+  * @retval None
+  */
+static void button_chord_eval(ButtonGroup* group, uint32_t pressed, uint32_t ticks)
+{
+	ButtonChord* next;
+	for (ButtonChord* chord = button_chord_next(group, BUTTON_CHORD_LINK(group->chords)); chord;
+	     chord = button_chord_next(group, next)) {
+		uint8_t held = (pressed & chord->mask) == chord->mask;
+		next = BUTTON_CHORD_LINK(chord->next);  // before the callbacks can stop or relink chord
+
+		if (!chord->active) {
+			if (held) {
+				chord->active = 1;
+				chord->long_fired = 0;
+				chord->ticks = 0;
+				chord->long_ticks = button_chord_long_ticks(group, chord->mask);
+				group->chord_suppressed |= chord->mask;
+				button_chord_emit(group, chord, BTN_CHORD_PRESS);
+			}
+		} else if (!held) {
+			chord->active = 0;
+			button_chord_emit(group, chord, BTN_CHORD_RELEASE);
+		} else if (!chord->long_fired) {
+			uint32_t held_ticks = chord->ticks + ticks;
+			chord->ticks = (held_ticks < UINT16_MAX) ? (uint16_t)held_ticks : UINT16_MAX;
+			if (chord->ticks > chord->long_ticks) {
+				chord->long_fired = 1;
+				button_chord_emit(group, chord, BTN_CHORD_LONG_PRESS);
+			}
+		}
+	}
+}
+
+/**
+  * @brief  Initialize a chord
+  * @param  chord: the chord struct
+  * @param  mask: member buttons, bit n = button_id n (at least two members)
+  * @retval None
+  */
+void button_chord_init(ButtonChord* chord, uint32_t mask)
+{
+	if (!chord || !(mask & (mask - 1))) return;  // parameter validation
+
+	memset(chord, 0, sizeof(ButtonChord));
+	chord->mask = mask;
+}
+
+/**
+  * @brief  Attach a chord event callback function
+  * @param  chord: the chord struct
+  * @param  event: chord event type
+  * @param  cb: callback function
+  * @param  user_data: user context pointer passed to callback (stored per-chord)
+  * @retval None
+  */
+void button_chord_attach(ButtonChord* chord, ButtonChordEvent event, BtnChordCallback cb, void* user_data)
+{
+	if (!chord || event >= BTN_CHORD_EVENT_COUNT) return;  // parameter validation
+	chord->cb[event] = cb;
+	chord->user_data = user_data;
+}
+
+/**
+  * @brief  Start chord detection, add the chord into the chord list of a group
+  *         Members are matched against the buttons of the same group. The
+  *         chord is published at the head after its links are set, so a
+  *         tick evaluating chords concurrently sees either list.
+  * @param  group: the group struct
+  * @param  chord: the chord struct
+  * @retval 0: succeed, -1: already exist (in any group), -2: invalid parameter
+  */
+BUTTON_GROUP_API int button_group_chord_start(ButtonGroup* group, ButtonChord* chord)
+{
+	if (!group || !chord || !chord->mask) return -2;  // invalid parameter
+
+	MULTIBUTTON_LOCK();
+	if (chord->group) {
+		MULTIBUTTON_UNLOCK();
+		return -1;  // already exist
+	}
+	chord->active = 0;
+	chord->next = group->chords;
+	chord->epoch = group->epoch;  // already visited by a pass in progress
+	chord->group = group;
+	MULTIBUTTON_BARRIER();  // links visible before publishing the chord
+	BUTTON_CHORD_LINK(group->chords) = chord;
 	MULTIBUTTON_UNLOCK();
 	return 0;
 }
 
 /**
-  * @brief  Stop the button work, remove the handle from work list
-  * @param  handle: target handle struct
+  * @brief  Start chord detection in the default group
+  * @param  chord: the chord struct
+  * @retval 0: succeed, -1: already exist, -2: invalid parameter
+  */
+int button_chord_start(ButtonChord* chord)
+{
+	return button_group_chord_start(&group_default, chord);
+}
+
+/**
+  * @brief  Stop chord detection, remove the chord from the chord list of a group
+  *         The chord's own next link is kept for a tick pass standing on it.
+  * @param  group: the group struct
+  * @param  chord: the chord struct
   * @retval None
   */
-void button_stop(Button* handle)
+BUTTON_GROUP_API void button_group_chord_stop(ButtonGroup* group, ButtonChord* chord)
 {
-	if (!handle) return;  // parameter validation
+	if (!group || !chord) return;  // parameter validation
 
 	MULTIBUTTON_LOCK();
-	Button** curr;
-	for (curr = &head_handle; *curr; ) {
-		Button* entry = *curr;
-		if (entry == handle) {
-			*curr = entry->next;
-			entry->next = NULL;  // clear next pointer
-			MULTIBUTTON_UNLOCK();
-			return;
-		} else {
-			curr = &entry->next;
+	if (chord->group == group) {
+		for (ButtonChord** curr = &group->chords; *curr; curr = &(*curr)->next) {
+			if (*curr == chord) {
+				BUTTON_CHORD_LINK(*curr) = chord->next;
+				break;
+			}
 		}
+		chord->group = NULL;
 	}
 	MULTIBUTTON_UNLOCK();
 }
 
 /**
-  * @brief  Background ticks, timer repeat invoking interval 5ms
-  *         Callbacks are executed outside the lock so they may safely
-  *         call button_start()/button_stop() without deadlock risk.
+  * @brief  Stop chord detection in the default group
+  * @param  chord: the chord struct
+  * @retval None
+  */
+void button_chord_stop(ButtonChord* chord)
+{
+	button_group_chord_stop(&group_default, chord);
+}
+#endif
+
+/**
+  * @brief  Background ticks of a group, timer repeat invoking interval 5ms
+  *         The button list is walked without taking the lock, and callbacks
+  *         may safely call button_start()/button_stop(). Different groups
+  *         share no state and may be ticked concurrently.
+  * @param  group: the group struct
+  * @retval None
+  */
+BUTTON_GROUP_API void button_group_ticks(ButtonGroup* group)
+{
+	if (!group) return;  // parameter validation
+
+#ifdef MULTIBUTTON_STATS
+	uint32_t tick_start = MULTIBUTTON_CYCLES();
+#endif
+#if MULTIBUTTON_TRACE_SIZE > 0
+	group->trace_tick++;
+#endif
+#if MULTIBUTTON_MAX_PORTS > 0
+	group->port_sampled = 0;  // invalidate port cache, ports are read lazily this tick
+#endif
+
+	BUTTON_PASS_BEGIN(group);
+#ifdef MULTIBUTTON_CHORDS
+	uint8_t chorded = (group->chords != NULL);
+	if (chorded) {
+		// Debounce every button first so chords see this tick's levels before any member event
+		uint32_t pressed = 0;
+		group->epoch++;
+		for (Button* b = button_list_next(group, BUTTON_LINK(group->head)); b;
+		     b = button_list_next(group, BUTTON_LINK(b->next))) {
+			if (b->input != BTN_INPUT_EDGE) {
+				button_debounce(b);
+			}
+			if (b->button_id < 32 && b->button_level == b->active_level) {
+				pressed |= 1UL << b->button_id;
+			}
+		}
+		button_chord_eval(group, pressed, 1);
+	}
+#endif
+
+	Button* next;
+	group->epoch++;
+	for (Button* target = button_list_next(group, BUTTON_LINK(group->head)); target;
+	     target = button_list_next(group, next)) {
+		next = BUTTON_LINK(target->next);  // before the callbacks can stop or relink target
+		if (target->input != BTN_INPUT_EDGE) {
+#ifdef MULTIBUTTON_CHORDS
+			if (chorded) {
+				button_step(target);  // debounced in the chord pass
+				continue;
+			}
+#endif
+			button_handler(target);
+		}
+	}
+	BUTTON_PASS_END(group);
+#if MULTIBUTTON_BATCH_SIZE > 0
+	button_batch_flush(group);
+#endif
+#ifdef MULTIBUTTON_STATS
+	button_stats_tick(group, MULTIBUTTON_CYCLES() - tick_start);
+#endif
+}
+
+/**
+  * @brief  Background ticks of the default group, timer repeat invoking interval 5ms
   * @param  None
   * @retval None
   */
 void button_ticks(void)
 {
+	button_group_ticks(&group_default);
+}
+
+/**
+  * @brief  Ticks until a button can take its next time-based transition
+  * @param  handle: the button handle struct
+  * @retval ticks until the next transition, BUTTON_DEADLINE_NONE if idle and stable
+  */
+static uint16_t button_deadline(Button* handle)
+{
+	// A level change still being debounced needs to be sampled every tick
+#if MULTIBUTTON_MAX_PORTS > 0
+	if (handle->input == BTN_INPUT_PORT) {
+		const ButtonDebounce* db = &BUTTON_GROUP(handle)->port_debounce[handle->port];
+		if ((db->cnt[0] | db->cnt[1] | db->cnt[2]) & handle->pin_mask) return 1;
+	}
+#endif
+	if (handle->debounce_cnt) {
+		return 1;
+	}
+
+	ButtonFsm fsm = button_fsm_load(handle);
+	uint16_t deadline = button_fsm_deadline(&fsm, handle->button_level == handle->active_level, BUTTON_PROFILE(handle));
+
+#ifdef MULTIBUTTON_TIME_DRIVEN
+	// Time-driven level change waiting for its debounce window
+	if (handle->edge_pending) {
+		uint32_t commit = button_edge_commit(handle);
+		if (commit < deadline) {
+			deadline = (uint16_t)commit;
+		}
+	}
+#endif
+	return deadline;
+}
+
+/**
+  * @brief  Get the number of ticks until the next time-based transition
+  *         of any button (long/short press timeouts, debounce window).
+  *         With unchanged inputs, the button_ticks() calls before that
+  *         deadline only advance counters, so a tickless system may sleep.
+  * @param  group: the group struct
+  * @retval ticks until the next transition, BUTTON_DEADLINE_NONE if all buttons are idle
+  */
+BUTTON_GROUP_API uint16_t button_group_next_deadline(ButtonGroup* group)
+{
+	uint16_t deadline = BUTTON_DEADLINE_NONE;
 	Button* target;
-	Button* next;
+
+	if (!group) return deadline;  // parameter validation
 
 	MULTIBUTTON_LOCK();
-	target = head_handle;
+	for (target = group->head; target; target = target->next) {
+		uint16_t d = button_deadline(target);
+		if (d < deadline) {
+			deadline = d;
+		}
+	}
 	MULTIBUTTON_UNLOCK();
+	return deadline;
+}
 
-	while (target) {
-		MULTIBUTTON_LOCK();
-		next = target->next;
-		MULTIBUTTON_UNLOCK();
+/**
+  * @brief  Get the number of ticks until the next transition in the default group
+  * @param  None
+  * @retval ticks until the next transition, BUTTON_DEADLINE_NONE if all buttons are idle
+  */
+uint16_t button_next_deadline(void)
+{
+	return button_group_next_deadline(&group_default);
+}
+
+/**
+  * @brief  Check whether every button of a group is idle, released and not debouncing
+  *         When true, the group's periodic tick may be stopped until a GPIO wake-up.
+  * @param  group: the group struct
+  * @retval 1: all buttons idle, 0: at least one button active
+  */
+BUTTON_GROUP_API int button_group_all_idle(ButtonGroup* group)
+{
+	return button_group_next_deadline(group) == BUTTON_DEADLINE_NONE;
+}
+
+/**
+  * @brief  Check whether every button of the default group is idle
+  * @param  None
+  * @retval 1: all buttons idle, 0: at least one button active
+  */
+int button_all_idle(void)
+{
+	return button_group_all_idle(&group_default);
+}
+
+#ifdef MULTIBUTTON_STATS
+/**
+  * @brief  Get the instrumentation counters of a button
+  * @param  handle: the button handle struct
+  * @retval counters, NULL if handle is NULL
+  */
+const ButtonStats* button_get_stats(Button* handle)
+{
+	if (!handle) return NULL;  // parameter validation
+	return &handle->stats;
+}
+
+/**
+  * @brief  Clear the instrumentation counters of a button
+  * @param  handle: the button handle struct
+  * @retval None
+  */
+void button_stats_reset(Button* handle)
+{
+	if (!handle) return;  // parameter validation
+	memset(&handle->stats, 0, sizeof(ButtonStats));
+}
+
+/**
+  * @brief  Get the tick duration histogram of a group
+  * @param  group: the group struct
+  * @retval histogram, NULL if group is NULL
+  */
+BUTTON_GROUP_API const ButtonTickStats* button_group_get_tick_stats(ButtonGroup* group)
+{
+	if (!group) return NULL;  // parameter validation
+	return &group->tick_stats;
+}
+
+/**
+  * @brief  Get the tick duration histogram of button_ticks()/button_ticks_at()
+  * @param  None
+  * @retval histogram
+  */
+const ButtonTickStats* button_get_tick_stats(void)
+{
+	return button_group_get_tick_stats(&group_default);
+}
+
+/**
+  * @brief  Clear the tick duration histogram of a group
+  * @param  group: the group struct
+  * @retval None
+  */
+BUTTON_GROUP_API void button_group_tick_stats_reset(ButtonGroup* group)
+{
+	if (!group) return;  // parameter validation
+	memset(&group->tick_stats, 0, sizeof(ButtonTickStats));
+}
+
+/**
+  * @brief  Clear the tick duration histogram
+  * @param  None
+  * @retval None
+  */
+void button_tick_stats_reset(void)
+{
+	button_group_tick_stats_reset(&group_default);
+}
+#endif
 
-		button_handler(target);
-		target = next;
+/**
+  * @brief  Initialize a button pool, removing all slots
+  * @param  pool: pool defined with BUTTON_POOL_DEFINE()
+  * @param  read_level: read the HAL GPIO level of a pool slot
+  * @retval None
+  */
+void button_pool_init(ButtonPool* pool, BtnPoolRead read_level)
+{
+	if (!pool) return;  // parameter validation
+
+	pool->read_level = read_level;
+	pool->profile = &button_profile_default;
+	pool->count = 0;
+}
+
+/**
+  * @brief  Set the timing profile shared by all slots of a pool
+  * @param  pool: the button pool
+  * @param  profile: timing thresholds, debounce_ticks at most 7
+  * @retval None
+  */
+void button_pool_set_profile(ButtonPool* pool, const ButtonProfile* profile)
+{
+	if (!pool || !profile || profile->debounce_ticks > 7) return;  // parameter validation
+	pool->profile = profile;
+}
+
+/**
+  * @brief  Add a button to the pool
+  * @param  pool: the button pool
+  * @param  active_level: pressed GPIO level
+  * @retval slot index (>= 0), -1: pool full, -2: invalid parameter
+  */
+int button_pool_add(ButtonPool* pool, uint8_t active_level)
+{
+	if (!pool) return -2;  // invalid parameter
+	if (pool->count >= pool->capacity) return -1;  // pool full
+
+	uint16_t i = pool->count++;
+	pool->ticks[i] = 0;
+#ifdef MULTIBUTTON_TYPEMATIC
+	pool->hold[i] = 0;
+#endif
+	// Idle, level initialized to opposite of active level
+	pool->flags[i] = (uint8_t)(BTN_STATE_IDLE | (active_level ? POOL_ACTIVE_BIT : POOL_LEVEL_BIT));
+	pool->repeat[i] = (uint8_t)(BTN_NONE_PRESS << POOL_EVENT_SHIFT);
+	memset(&pool->cold[i], 0, sizeof(ButtonPoolCold));
+	return i;
+}
+
+/**
+  * @brief  Attach an event callback to a pool slot
+  * @param  pool: the button pool
+  * @param  index: slot index
+  * @param  event: trigger event type
+  * @param  cb: callback function
+  * @param  user_data: user context pointer passed to callback (stored per-slot)
+  * @retval None
+  */
+void button_pool_attach(ButtonPool* pool, uint16_t index, ButtonEvent event, BtnPoolCallback cb, void* user_data)
+{
+	if (!pool || index >= pool->count || event >= BTN_EVENT_COUNT) return;  // parameter validation
+	pool->cold[index].cb[event] = cb;
+	pool->cold[index].user_data = user_data;
+}
+
+/**
+  * @brief  Get the event of a pool slot
+  * @param  pool: the button pool
+  * @param  index: slot index
+  * @retval button event
+  */
+ButtonEvent button_pool_get_event(ButtonPool* pool, uint16_t index)
+{
+	if (!pool || index >= pool->count) return BTN_NONE_PRESS;
+	return (ButtonEvent)(pool->repeat[index] >> POOL_EVENT_SHIFT);
+}
+
+/**
+  * @brief  Get the repeat count of a pool slot
+  * @param  pool: the button pool
+  * @param  index: slot index
+  * @retval repeat count
+  */
+uint8_t button_pool_get_repeat_count(ButtonPool* pool, uint16_t index)
+{
+	if (!pool || index >= pool->count) return 0;
+	return pool->repeat[index] & POOL_REPEAT_MASK;
+}
+
+/**
+  * @brief  Check if a pool slot is currently pressed
+  * @param  pool: the button pool
+  * @param  index: slot index
+  * @retval 1: pressed, 0: not pressed, -1: error
+  */
+int button_pool_is_pressed(ButtonPool* pool, uint16_t index)
+{
+	if (!pool || index >= pool->count) return -1;
+	uint8_t flags = pool->flags[index];
+	return (!(flags & POOL_LEVEL_BIT) == !(flags & POOL_ACTIVE_BIT)) ? 1 : 0;
+}
+
+/**
+  * @brief  Background ticks for a button pool, same timing as button_ticks()
+  *         Scans the hot arrays linearly; idle released buttons take a
+  *         fast path that never touches ticks or the cold data. Callbacks
+  *         see the slot as list button callbacks see theirs.
+  * @param  pool: the button pool
+  * @retval None
+  */
+void button_pool_ticks(ButtonPool* pool)
+{
+	if (!pool || !pool->read_level || !pool->profile) return;  // parameter validation
+
+	const ButtonProfile* profile = pool->profile;
+	for (uint16_t i = 0; i < pool->count; i++) {
+		uint8_t flags = pool->flags[i];
+		uint8_t level = pool->read_level(i) ? POOL_LEVEL_BIT : 0;
+		uint8_t cnt = (flags & POOL_DEBOUNCE_MASK) >> POOL_DEBOUNCE_SHIFT;
+
+		/* Button debounce handling */
+		if (level != (flags & POOL_LEVEL_BIT)) {
+			if (++cnt >= profile->debounce_ticks) {
+				flags ^= POOL_LEVEL_BIT;
+				cnt = 0;
+			}
+		} else {
+			cnt = 0;
+		}
+		flags = (uint8_t)((flags & ~POOL_DEBOUNCE_MASK) | (cnt << POOL_DEBOUNCE_SHIFT));
+
+		uint8_t pressed = !(flags & POOL_LEVEL_BIT) == !(flags & POOL_ACTIVE_BIT);
+		uint8_t rep = pool->repeat[i];
+
+		// Fast path: idle and released, only the polled event needs clearing
+		if ((flags & POOL_STATE_MASK) == BTN_STATE_IDLE && !pressed) {
+			pool->flags[i] = flags;
+			if ((rep >> POOL_EVENT_SHIFT) != BTN_NONE_PRESS) {
+				pool->repeat[i] = (uint8_t)((BTN_NONE_PRESS << POOL_EVENT_SHIFT) | (rep & POOL_REPEAT_MASK));
+			}
+			continue;
+		}
+
+		/* State machine */
+		ButtonFsm fsm;
+		fsm.ticks = pool->ticks[i];
+		fsm.state = (uint8_t)(flags & POOL_STATE_MASK);
+		fsm.repeat = (uint8_t)(rep & POOL_REPEAT_MASK);
+#ifdef MULTIBUTTON_TYPEMATIC
+		fsm.hold = pool->hold[i];
+#endif
+		uint8_t events = button_fsm_step(&fsm, pressed, profile);
+
+		pool->ticks[i] = fsm.ticks;
+#ifdef MULTIBUTTON_TYPEMATIC
+		pool->hold[i] = fsm.hold;
+#endif
+		pool->flags[i] = (uint8_t)((flags & ~POOL_STATE_MASK) | fsm.state);
+
+		// Same order as list buttons: callbacks see the repeat count before
+		// the transition, BTN_PRESS_REPEAT the incremented one
+		uint8_t repeat = (uint8_t)(rep & POOL_REPEAT_MASK);
+		for (uint8_t ev = 0; events; ev++, events >>= 1) {
+			if (events & 1U) {
+				if (ev == BTN_PRESS_REPEAT) {
+					repeat = fsm.repeat;
+				}
+				rep = (uint8_t)((ev << POOL_EVENT_SHIFT) | repeat);
+				pool->repeat[i] = rep;
+				if (pool->cold[i].cb[ev]) {
+					pool->cold[i].cb[ev](pool, i, pool->cold[i].user_data);
+				}
+			}
+		}
+		pool->repeat[i] = (uint8_t)((rep & ~POOL_REPEAT_MASK) | fsm.repeat);
 	}
 }
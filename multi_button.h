@@ -20,18 +20,88 @@
 #define SHORT_TICKS             (300 / TICKS_INTERVAL)   // short press threshold
 #define LONG_TICKS              (1000 / TICKS_INTERVAL)  // long press threshold
 #define PRESS_REPEAT_MAX_NUM    15   // maximum repeat counter value
+#define BUTTON_DEADLINE_NONE    UINT16_MAX  // button_next_deadline(): no transition pending
+
+// Debounce window of time-driven buttons: a level change is accepted once it is still
+// present DEBOUNCE_MS after it was first seen (same as DEBOUNCE_TICKS samples at TICKS_INTERVAL)
+#define DEBOUNCE_MS             ((DEBOUNCE_TICKS > 1 ? DEBOUNCE_TICKS - 1 : 0) * TICKS_INTERVAL)
+
+// Number of 32-bit GPIO port words available to port-mapped buttons and matrix keypads,
+// 0: no port-mapped buttons (port fields and functions are not compiled in)
+#ifndef MULTIBUTTON_MAX_PORTS
+#define MULTIBUTTON_MAX_PORTS   0
+#endif
+
+// Optional per-button features. Each one adds RAM to every Button, so all are off by default.
+// MULTIBUTTON_TIME_DRIVEN: button_ticks_at(), button_ticks_elapsed() and edge-driven buttons
+// MULTIBUTTON_PROFILES:    button_set_profile(), otherwise buttons use button_profile_default
+// MULTIBUTTON_GROUPS:      button_group_*(), otherwise all buttons are in one built-in group
+// MULTIBUTTON_FAST_STOP:   constant-time button_stop(), otherwise it searches the list (O(n))
+
+// Call period recommended by button_ticks_elapsed() while every button is idle and stable
+#ifndef MULTIBUTTON_IDLE_INTERVAL
+#define MULTIBUTTON_IDLE_INTERVAL  50   // ms
+#endif
 
 // Compile-time check: debounce_cnt is a 3-bit field, max value is 7
 #if DEBOUNCE_TICKS > 7
   #error "DEBOUNCE_TICKS exceeds 3-bit field maximum (7)"
 #endif
 
-// Forward declaration
+// Compile-time check: the idle period is at least one tick and fits the 16-bit return value
+#if MULTIBUTTON_IDLE_INTERVAL < TICKS_INTERVAL || MULTIBUTTON_IDLE_INTERVAL > 65535
+  #error "MULTIBUTTON_IDLE_INTERVAL must be in range TICKS_INTERVAL ~ 65535"
+#endif
+
+// Compile-time check: sampled ports are tracked in a 32-bit mask per tick
+#if MULTIBUTTON_MAX_PORTS < 0 || MULTIBUTTON_MAX_PORTS > 32
+  #error "MULTIBUTTON_MAX_PORTS must be in range 0 ~ 32"
+#endif
+
+// Forward declarations
 typedef struct _Button Button;
+typedef struct _ButtonGroup ButtonGroup;
 
 // Button callback function type
 typedef void (*BtnCallback)(Button* handle, void* user_data);
 
+// Port read function type: returns the whole 32-bit input word of a GPIO port
+typedef uint32_t (*BtnPortRead)(uint8_t port);
+
+// Machine word for bit-sliced debounce (define MULTIBUTTON_SLICE_64 for 64 inputs per word)
+#ifdef MULTIBUTTON_SLICE_64
+typedef uint64_t ButtonSlice;
+#else
+typedef uint32_t ButtonSlice;
+#endif
+
+// Bit-sliced debounce state: DEBOUNCE_TICKS counter stored as vertical bit planes,
+// one bit per input, so a whole word of inputs is filtered with a few AND/XOR ops
+typedef struct {
+	ButtonSlice level;                  // debounced input levels
+	ButtonSlice cnt[3];                 // counter bit planes (bit 0, 1, 2)
+} ButtonDebounce;
+
+// Matrix keypad row driver: make 'row' the only active row
+typedef void (*BtnMatrixDrive)(uint8_t row);
+
+// Matrix keypad column reader: column bitmap of the active row, bit c set = key closed
+typedef uint8_t (*BtnMatrixRead)(void);
+
+// Matrix keypad scanner (up to 8x8): each row is driven once per tick and all columns are
+// read in one access. The key snapshot, bit (row * 8 + col), feeds one or two consecutive
+// port words of the port-mapped buttons, which debounce it bit-sliced.
+typedef struct {
+	BtnMatrixDrive drive_row;           // row driver
+	BtnMatrixRead  read_cols;           // column reader
+	uint8_t  rows;                      // number of rows (1 ~ 8)
+	uint8_t  cols;                      // number of columns (1 ~ 8)
+	uint8_t  port;                      // first port word fed with the snapshot
+	uint8_t  ghosted;                   // last scan was rejected as ambiguous
+	uint32_t ghost_count;               // number of rejected scans
+	uint64_t snapshot;                  // last accepted key state, bit (row * 8 + col)
+} ButtonMatrix;
+
 // Button event types
 typedef enum {
 	BTN_PRESS_DOWN = 0,     // button pressed down
@@ -54,9 +124,90 @@ typedef enum {
 	BTN_STATE_LONG_HOLD     // long press hold state
 } ButtonState;
 
+// Button input source
+typedef enum {
+	BTN_INPUT_PIN = 0,      // per-button HAL function (hal_button_level)
+	BTN_INPUT_PORT,         // bit of a port word sampled once per tick
+	BTN_INPUT_EDGE          // level changes reported by button_on_edge()
+} ButtonInput;
+
+// Shared button configuration: HAL read function, callbacks and user_data.
+// With MULTIBUTTON_CONST_CONFIG defined, a Button only stores a pointer to its
+// configuration, which can be a 'static const' table in flash shared by many buttons;
+// button_init()/button_attach()/button_detach() are then not available.
+// Without it, button_init_config() copies the configuration into the Button.
+// The subscribed events are taken from the configuration by button_init_config() and
+// button_set_config(); call button_set_config() again after changing its callbacks.
+typedef struct {
+	uint8_t  (*hal_button_level)(uint8_t button_id);  // HAL function to read GPIO (pin buttons)
+	BtnCallback cb[BTN_EVENT_COUNT];    // callback function array
+	void*    user_data;                 // user context pointer passed to callbacks
+} ButtonConfig;
+
+// Timing profile: per-button thresholds in ticks, usually a 'static const' shared by
+// all buttons of one kind. The configuration macros above form button_profile_default.
+// With MULTIBUTTON_TYPEMATIC defined and hold_interval set, BTN_LONG_PRESS_HOLD repeats like
+// keyboard typematic instead of firing every tick: first hold_delay ticks after
+// BTN_LONG_PRESS_START, then every hold_interval ticks, halved after every hold_accel repeats
+// down to hold_min_interval. Without MULTIBUTTON_TYPEMATIC the hold_* fields are ignored.
+typedef struct {
+	uint16_t short_ticks;               // click window / repeat threshold
+	uint16_t long_ticks;                // long press threshold
+	uint8_t  debounce_ticks;            // debounce filter depth, MAX 7 (pin and edge buttons)
+	uint8_t  hold_accel;                // typematic: repeats per acceleration step, 0: no acceleration
+	uint16_t hold_delay;                // typematic: ticks from BTN_LONG_PRESS_START to the first repeat
+	uint16_t hold_interval;             // typematic: ticks between repeats, 0: every tick (default)
+	uint16_t hold_min_interval;         // typematic: shortest interval reached by acceleration
+} ButtonProfile;
+
+// Optional press-sequence gestures.
+// Define MULTIBUTTON_GESTURES to enable button_set_gestures(). A gesture is 'presses' presses
+// in a row, each starting within short_ticks of the previous release. Without 'hold' the
+// sequence ends with the click timeout; with 'hold' the last press is held to the long press
+// threshold. Tables end with presses == 0. Without MULTIBUTTON_GESTURES nothing is compiled in.
+#ifdef MULTIBUTTON_GESTURES
+typedef struct {
+	uint8_t  presses;                   // presses in the sequence (1 ~ PRESS_REPEAT_MAX_NUM)
+	uint8_t  hold;                      // 0: clicks only, 1: last press held (long press)
+	BtnCallback cb;                     // called once when the gesture is recognized
+} ButtonGesture;
+#endif
+
+// Optional hot-path instrumentation.
+// Define MULTIBUTTON_STATS to count events and debounce rejections per button, record the
+// longest event callback and keep a log2 histogram of button_ticks()/button_ticks_at()
+// durations. Durations are read from MULTIBUTTON_CYCLES(), a free-running counter such as
+// DWT->CYCCNT; if the macro is not defined the application provides button_cycles().
+// Without MULTIBUTTON_STATS nothing is compiled in.
+#ifdef MULTIBUTTON_STATS
+  #ifndef MULTIBUTTON_CYCLES
+    #define MULTIBUTTON_CYCLES() button_cycles()
+  #endif
+
+#define BUTTON_STATS_BUCKETS 32
+
+// Per-button counters (saturating)
+typedef struct {
+	uint16_t events[BTN_EVENT_COUNT];   // events emitted, per event type
+	uint16_t bounces;                   // level changes rejected by the debounce filter
+	uint32_t max_cb_cycles;             // longest event callback in MULTIBUTTON_CYCLES() units
+} ButtonStats;
+
+// Tick duration histogram: bucket 0 counts 0 cycles, bucket n counts 2^(n-1) ~ 2^n - 1
+// cycles, the last bucket also counts everything longer
+typedef struct {
+	uint32_t hist[BUTTON_STATS_BUCKETS];
+	uint32_t max_cycles;                // longest tick
+	uint32_t count;                     // ticks measured
+} ButtonTickStats;
+#endif
+
 // Button structure
 struct _Button {
 	uint16_t ticks;                     // tick counter
+#ifdef MULTIBUTTON_TYPEMATIC
+	uint16_t hold;                      // typematic repeats since BTN_LONG_PRESS_START
+#endif
 	uint8_t  repeat : 4;                // repeat counter (0-15)
 	uint8_t  event : 4;                 // current event (0-15)
 	uint8_t  state : 3;                 // state machine state (0-7)
@@ -64,18 +215,145 @@ struct _Button {
 	uint8_t  active_level : 1;          // active GPIO level (0 or 1)
 	uint8_t  button_level : 1;          // current button level
 	uint8_t  button_id;                 // button identifier
+	uint8_t  input : 2;                 // input source (ButtonInput)
+#ifndef MULTIBUTTON_FAST_STOP
+	uint8_t  linked : 1;                // in a button list
+#endif
+#ifdef MULTIBUTTON_TIME_DRIVEN
+	uint8_t  edge_pending : 1;          // level change waiting for the debounce window (time-driven)
+#endif
+#ifdef MULTIBUTTON_GESTURES
+	uint8_t  seq : 4;                   // presses in the current sequence (gestures)
+#endif
+	uint8_t  epoch;                     // tick pass that last visited this button
+	uint8_t  cb_mask;                   // subscribed events, bit n set = callback attached for event n
+#if MULTIBUTTON_MAX_PORTS > 0
+	uint8_t  port;                      // port index (BTN_INPUT_PORT only, debounced per port word)
+	uint32_t pin_mask;                  // pin bit mask within port word (BTN_INPUT_PORT only)
+#endif
+#ifdef MULTIBUTTON_TIME_DRIVEN
+	uint32_t stamp_ms;                  // time of the last processed tick (time-driven)
+	uint32_t edge_ms;                   // time the pending level change was first seen (time-driven)
+#endif
+#ifdef MULTIBUTTON_PROFILES
+	const ButtonProfile* profile;       // timing thresholds
+#endif
+#ifdef MULTIBUTTON_GESTURES
+	const ButtonGesture* gestures;      // gesture table, NULL if none
+#endif
+#ifdef MULTIBUTTON_CONST_CONFIG
+	const ButtonConfig* config;         // shared configuration (HAL, callbacks, user_data)
+#else
 	uint8_t  (*hal_button_level)(uint8_t button_id);  // HAL function to read GPIO
 	BtnCallback cb[BTN_EVENT_COUNT];    // callback function array
 	void*    user_data;                 // user context pointer passed to callbacks
+#endif
+#ifdef MULTIBUTTON_STATS
+	ButtonStats stats;                  // instrumentation counters
+#endif
+#ifdef MULTIBUTTON_GROUPS
+	ButtonGroup* group;                 // group the button was last started in
+#endif
 	Button* next;                       // next button in linked list
+#ifdef MULTIBUTTON_FAST_STOP
+	Button** pprev;                     // link pointing to this button, NULL when not started
+#endif
 };
 
+// Optional chords.
+// Define MULTIBUTTON_CHORDS to enable the button_chord_*() functions. Without it nothing is
+// compiled in and button_ticks() debounces and steps each button in a single pass.
+#ifdef MULTIBUTTON_CHORDS
+// Chord events
+typedef enum {
+	BTN_CHORD_PRESS = 0,    // all member buttons pressed
+	BTN_CHORD_RELEASE,      // first member released after the chord formed
+	BTN_CHORD_LONG_PRESS,   // chord held past the longest long_ticks of its members
+	BTN_CHORD_EVENT_COUNT   // total number of chord events
+} ButtonChordEvent;
+
+// Chord: a combination of buttons pressed together, members selected by button_id bit
+// (button_id 0 ~ 31, buttons with a larger id cannot be members). Evaluated once per
+// button_ticks() or button_ticks_at()/button_ticks_elapsed() call against a pressed-state bitmap.
+typedef struct _ButtonChord ButtonChord;
+
+// Chord callback function type
+typedef void (*BtnChordCallback)(ButtonChord* chord, void* user_data);
+
+struct _ButtonChord {
+	uint32_t mask;                      // member buttons, bit n = button_id n
+	uint16_t ticks;                     // ticks since the chord formed
+	uint16_t long_ticks;                // long press threshold, the longest of the members' profiles
+	uint8_t  active : 1;                // all members pressed
+	uint8_t  long_fired : 1;            // BTN_CHORD_LONG_PRESS already emitted
+	uint8_t  epoch;                     // last tick pass that evaluated the chord
+	BtnChordCallback cb[BTN_CHORD_EVENT_COUNT];  // callback function array
+	void*    user_data;                 // user context pointer passed to callbacks
+	ButtonGroup* group;                 // group the chord is started in, NULL when stopped
+	ButtonChord* next;                  // next chord in linked list
+};
+#endif
+
+// Button pool: an alternative to the intrusive linked list for large button counts.
+// Hot state (ticks, state, debounce, levels) lives in contiguous parallel arrays so
+// button_pool_ticks() is a linear scan; callbacks and user_data are kept apart.
+typedef struct _ButtonPool ButtonPool;
+
+// Pool callback function type, index is the slot returned by button_pool_add()
+typedef void (*BtnPoolCallback)(ButtonPool* pool, uint16_t index, void* user_data);
+
+// Pool level read function type: returns the GPIO level of a pool slot
+typedef uint8_t (*BtnPoolRead)(uint16_t index);
+
+// Cold per-slot data, only touched when an event is dispatched
+typedef struct {
+	BtnPoolCallback cb[BTN_EVENT_COUNT];  // callback function array
+	void*    user_data;                 // user context pointer passed to callbacks
+} ButtonPoolCold;
+
+struct _ButtonPool {
+	uint16_t*       ticks;              // tick counters
+	uint8_t*        flags;              // state (bits 0-2), debounce (bits 3-5), level (bit 6), active level (bit 7)
+	uint8_t*        repeat;             // repeat counter (bits 0-3), current event (bits 4-7)
+	ButtonPoolCold* cold;               // callbacks and user_data
+	BtnPoolRead     read_level;         // HAL function to read GPIO of a slot
+	const ButtonProfile* profile;       // timing thresholds shared by all slots
+	uint16_t        count;              // slots in use
+	uint16_t        capacity;           // slots available
+#ifdef MULTIBUTTON_TYPEMATIC
+	uint16_t*       hold;               // typematic repeats since BTN_LONG_PRESS_START
+#endif
+};
+
+// Define a pool with static storage for 'size' buttons
+#ifdef MULTIBUTTON_TYPEMATIC
+#define BUTTON_POOL_DEFINE(name, size) \
+	static uint16_t name##_ticks[size]; \
+	static uint8_t  name##_flags[size]; \
+	static uint8_t  name##_repeat[size]; \
+	static ButtonPoolCold name##_cold[size]; \
+	static uint16_t name##_hold[size]; \
+	static ButtonPool name = { name##_ticks, name##_flags, name##_repeat, name##_cold, NULL, NULL, 0, (size), name##_hold }
+#else
+#define BUTTON_POOL_DEFINE(name, size) \
+	static uint16_t name##_ticks[size]; \
+	static uint8_t  name##_flags[size]; \
+	static uint8_t  name##_repeat[size]; \
+	static ButtonPoolCold name##_cold[size]; \
+	static ButtonPool name = { name##_ticks, name##_flags, name##_repeat, name##_cold, NULL, NULL, 0, (size) }
+#endif
+
 // Optional thread-safety support for RTOS environments.
 // Define MULTIBUTTON_THREAD_SAFE and provide MULTIBUTTON_LOCK()/MULTIBUTTON_UNLOCK()
 // macros before including this header to enable thread-safe list operations.
 //
 // NOTE: Callbacks are executed OUTSIDE the lock, so a regular (non-recursive) mutex
 // is safe. Callbacks may freely call button_stop()/button_start() without deadlock.
+// button_ticks()/button_ticks_at() walk the button and chord lists without taking the
+// lock; only list changes (start/stop of buttons and chords) are serialized by it. After
+// stopping a button or chord, button_synchronize() waits for a tick pass still running
+// on another thread to leave it. MULTIBUTTON_RELAX() is called while waiting; define it
+// to a sleep (e.g. osDelay(1)) when the waiting thread may outrank the ticking thread.
 //
 // Example:
 //   #define MULTIBUTTON_THREAD_SAFE
@@ -86,29 +364,305 @@ struct _Button {
   #if !defined(MULTIBUTTON_LOCK) || !defined(MULTIBUTTON_UNLOCK)
     #error "Define MULTIBUTTON_LOCK() and MULTIBUTTON_UNLOCK() when using MULTIBUTTON_THREAD_SAFE"
   #endif
+  #ifndef MULTIBUTTON_RELAX
+    #define MULTIBUTTON_RELAX()
+  #endif
 #else
   #define MULTIBUTTON_LOCK()
   #define MULTIBUTTON_UNLOCK()
 #endif
 
+// Optional table-driven state machine.
+// Define MULTIBUTTON_FSM_TABLE to replace the switch-based state machine with a const
+// transition table indexed by (state, pressed, timeout expired) that yields the next state,
+// the events to emit and the tick/repeat action. Behaviour is identical; bench/bench_fsm.c
+// compares code size and cycles per tick of both engines.
+
+// Optional deferred callback dispatch.
+// Define MULTIBUTTON_EVENT_QUEUE_SIZE (power of 2) to make button_ticks()/button_ticks_at()/
+// button_on_edge() push (button, event) records into a lock-free single-producer/single-
+// consumer ring buffer instead of invoking callbacks. The main loop runs the callbacks with
+// button_dispatch_pending(). Records that do not fit are dropped and counted.
+//
+// NOTE: The producer side (all tick/edge calls) must run in a single context, and callbacks
+// see the live button state, which may have advanced since the event was queued. Inside a
+// callback, button_get_dispatched_event() reports the queued event; button_get_event()
+// always reports the live one, so the producer context may keep polling it.
+// MULTIBUTTON_BARRIER() defaults to a full compiler/memory barrier on GCC/Clang.
+#ifndef MULTIBUTTON_EVENT_QUEUE_SIZE
+  #define MULTIBUTTON_EVENT_QUEUE_SIZE 0
+#endif
+#if MULTIBUTTON_EVENT_QUEUE_SIZE & (MULTIBUTTON_EVENT_QUEUE_SIZE - 1)
+  #error "MULTIBUTTON_EVENT_QUEUE_SIZE must be a power of 2"
+#endif
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 32768
+  #error "MULTIBUTTON_EVENT_QUEUE_SIZE exceeds 16-bit index range"
+#endif
+#ifndef MULTIBUTTON_BARRIER
+  #if defined(__GNUC__) || defined(__clang__)
+    #define MULTIBUTTON_BARRIER() __sync_synchronize()
+  #else
+    #define MULTIBUTTON_BARRIER()
+  #endif
+#endif
+
+// Optional batched event sink.
+// Define MULTIBUTTON_BATCH_SIZE to collect every event of one button_ticks()/button_ticks_at()
+// pass (or one button_on_edge() call) into an array delivered with a single sink call.
+// A batch is delivered early when the buffer fills up. Callbacks still fire as usual.
+#ifndef MULTIBUTTON_BATCH_SIZE
+  #define MULTIBUTTON_BATCH_SIZE 0
+#endif
+
+// Batched event record
+typedef struct {
+	uint8_t  button_id;                 // button identifier
+	uint8_t  event;                     // ButtonEvent
+	uint8_t  repeat;                    // repeat counter when the event fired
+} ButtonEventRecord;
+
+// Batch sink function type
+typedef void (*BtnBatchSink)(const ButtonEventRecord* records, uint16_t count, void* user_data);
+
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+// Deferred dispatch record: compact (source, event) pair
+typedef struct {
+	void*    source;                    // Button*, or ButtonChord* for chord events
+	uint8_t  event;
+} ButtonQueued;
+#endif
+
+// Optional trace recorder.
+// Define MULTIBUTTON_TRACE_SIZE (power of 2) to record every state machine transition of a
+// list button into a ring of packed 32-bit records, overwriting the oldest. A transition that
+// emits several events is recorded once per event; repeating LONG_PRESS_HOLD ticks are not
+// recorded. Dump with button_trace_dump() and decode with tools/trace_decode.c.
+#ifndef MULTIBUTTON_TRACE_SIZE
+  #define MULTIBUTTON_TRACE_SIZE 0
+#endif
+#if MULTIBUTTON_TRACE_SIZE & (MULTIBUTTON_TRACE_SIZE - 1)
+  #error "MULTIBUTTON_TRACE_SIZE must be a power of 2"
+#endif
+
+// Trace record layout: tick:15 (button_ticks() count, or ms / TICKS_INTERVAL when time-driven,
+// wraps), old_state:3, new_state:3, event:3 (BUTTON_TRACE_NO_EVENT if none), button_id:8
+#define BUTTON_TRACE_NO_EVENT        7U
+#define BUTTON_TRACE_PACK(tick, id, old_state, new_state, event) \
+	((uint32_t)((tick) & 0x7FFFU) | (uint32_t)((old_state) & 0x7U) << 15 | \
+	 (uint32_t)((new_state) & 0x7U) << 18 | (uint32_t)((event) & 0x7U) << 21 | (uint32_t)(id) << 24)
+#define BUTTON_TRACE_TICK(rec)       ((uint16_t)((rec) & 0x7FFFU))
+#define BUTTON_TRACE_OLD_STATE(rec)  ((uint8_t)((rec) >> 15 & 0x7U))
+#define BUTTON_TRACE_NEW_STATE(rec)  ((uint8_t)((rec) >> 18 & 0x7U))
+#define BUTTON_TRACE_EVENT(rec)      ((uint8_t)((rec) >> 21 & 0x7U))
+#define BUTTON_TRACE_ID(rec)         ((uint8_t)((rec) >> 24))
+
+// Button group: an independent button list with its own chords, port words, queue, batch,
+// trace and tick statistics. Groups share no mutable state, so each can be ticked from its
+// own thread, core or ISR at its own rate. The functions without a group parameter operate
+// on a built-in default group. Treat the members as private.
+struct _ButtonGroup {
+	Button*  head;                      // button list head
+	uint8_t  epoch;                     // tick pass counter (see button_list_next())
+#ifdef MULTIBUTTON_THREAD_SAFE
+	volatile uint32_t passes;           // tick passes begun plus ended, odd while one runs
+#endif
+#ifdef MULTIBUTTON_TIME_DRIVEN
+	uint32_t clock_ms;                  // time accumulated by button_group_ticks_elapsed()
+#endif
+#ifdef MULTIBUTTON_CHORDS
+	ButtonChord* chords;                // chord list head
+	uint32_t chord_suppressed;          // members whose individual events are suppressed
+#ifdef MULTIBUTTON_TIME_DRIVEN
+	uint32_t chord_ms;                  // time of the last chord tick (time-driven passes)
+#endif
+#endif
+#if MULTIBUTTON_MAX_PORTS > 0
+	BtnPortRead port_read;              // port reader of port-mapped buttons
+	uint32_t port_sampled;              // ports sampled this tick
+	uint32_t port_raw[MULTIBUTTON_MAX_PORTS];           // raw port words of this tick
+	ButtonDebounce port_debounce[MULTIBUTTON_MAX_PORTS];  // debounced port words (tick context only)
+	uint32_t port_seed_level[MULTIBUTTON_MAX_PORTS];    // levels to seed started pins with
+	volatile uint32_t port_seed_req[MULTIBUTTON_MAX_PORTS];   // seed requests, toggled by button_group_start()
+	volatile uint32_t port_seed_done[MULTIBUTTON_MAX_PORTS];  // seeds applied, toggled by the tick
+	ButtonMatrix* port_matrix[MULTIBUTTON_MAX_PORTS];   // matrix owning a port word, or NULL
+#endif
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+	ButtonQueued queue_buf[MULTIBUTTON_EVENT_QUEUE_SIZE];  // SPSC ring of deferred events
+	volatile uint16_t queue_head;       // written by the producer (tick context) only
+	volatile uint16_t queue_tail;       // written by the consumer (main loop) only
+	volatile uint32_t queue_overflow;   // records dropped on a full ring
+	Button*  queue_source;              // button whose callback is being dispatched (consumer only)
+	uint8_t  queue_event;               // event of that callback, see button_get_dispatched_event()
+#endif
+#if MULTIBUTTON_BATCH_SIZE > 0
+	BtnBatchSink batch_sink;            // batch sink, NULL if none
+	void*    batch_user_data;           // user context pointer passed to the sink
+	ButtonEventRecord batch_buf[MULTIBUTTON_BATCH_SIZE];  // events of the current pass
+	uint16_t batch_count;               // records in batch_buf
+#endif
+#if MULTIBUTTON_TRACE_SIZE > 0
+	uint32_t trace_buf[MULTIBUTTON_TRACE_SIZE];  // trace ring, oldest records overwritten
+	uint32_t trace_head;                // free-running write index
+	uint16_t trace_tick;                // tick stamped into new records
+#endif
+#ifdef MULTIBUTTON_STATS
+	ButtonTickStats tick_stats;         // tick duration histogram
+#if MULTIBUTTON_MAX_PORTS > 0
+	uint32_t port_rejected[MULTIBUTTON_MAX_PORTS];  // pins whose level change bounced this tick
+#endif
+#endif
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Default timing profile built from SHORT_TICKS, LONG_TICKS and DEBOUNCE_TICKS
+extern const ButtonProfile button_profile_default;
+
 // Public API functions
+#ifndef MULTIBUTTON_CONST_CONFIG
 void button_init(Button* handle, uint8_t(*pin_level)(uint8_t), uint8_t active_level, uint8_t button_id);
 void button_attach(Button* handle, ButtonEvent event, BtnCallback cb, void* user_data);
 void button_detach(Button* handle, ButtonEvent event);
+#endif
+void button_init_config(Button* handle, const ButtonConfig* config, uint8_t active_level, uint8_t button_id);
+void button_set_config(Button* handle, const ButtonConfig* config);
+#ifdef MULTIBUTTON_PROFILES
+void button_set_profile(Button* handle, const ButtonProfile* profile);
+#endif
+#ifdef MULTIBUTTON_GESTURES
+void button_set_gestures(Button* handle, const ButtonGesture* gestures);
+#endif
 ButtonEvent button_get_event(Button* handle);
+ButtonEvent button_get_dispatched_event(Button* handle);  // event a callback runs for (deferred dispatch)
 int  button_start(Button* handle);
 void button_stop(Button* handle);
 void button_ticks(void);
 
+// Wait until a tick pass running at the call has finished, e.g. before reusing a stopped button
+void button_synchronize(void);
+
+#ifdef MULTIBUTTON_TIME_DRIVEN
+// Time-driven ticking: advance all buttons to a monotonic timestamp, catching up missed ticks
+void button_ticks_at(uint32_t now_ms);
+
+// Adaptive ticking: advance by the elapsed time, returns the recommended ms until the next call
+uint16_t button_ticks_elapsed(uint32_t elapsed_ms);
+
+// Edge-driven buttons: GPIO interrupts report level changes with a millisecond timestamp,
+// button_ticks_at() only has to run for pending debounce windows and timeouts
+void button_init_edge(Button* handle, uint8_t active_level, uint8_t button_id);
+void button_on_edge(Button* handle, uint8_t level, uint32_t timestamp_ms);
+#endif
+
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+// Deferred dispatch: run queued callbacks (consumer side), returns number dispatched
+uint16_t button_dispatch_pending(void);
+uint32_t button_queue_overflows(void);
+#endif
+
+#if MULTIBUTTON_BATCH_SIZE > 0
+// Batched dispatch: one sink call per tick with all events of that tick
+void button_set_batch_sink(BtnBatchSink sink, void* user_data);
+#endif
+
+#if MULTIBUTTON_TRACE_SIZE > 0
+// Trace recorder: copy records oldest first, returns number copied; call from the tick context
+uint16_t button_trace_dump(uint32_t* out, uint16_t max);
+void button_trace_clear(void);
+#endif
+
+#ifdef MULTIBUTTON_STATS
+// Instrumentation: per-button counters and tick duration histogram
+const ButtonStats* button_get_stats(Button* handle);
+void button_stats_reset(Button* handle);
+const ButtonTickStats* button_get_tick_stats(void);
+void button_tick_stats_reset(void);
+uint32_t button_cycles(void);  // application-supplied when MULTIBUTTON_CYCLES() is not defined
+#endif
+
+// Tickless support: ticks until the next time-based transition, all-idle indicator
+uint16_t button_next_deadline(void);
+int  button_all_idle(void);
+
+#if MULTIBUTTON_MAX_PORTS > 0
+// Port-mapped buttons: one port read per tick shared by all buttons on that port
+void button_port_init(BtnPortRead read_port);
+void button_init_port(Button* handle, uint8_t port, uint32_t pin_mask, uint8_t active_level, uint8_t button_id);
+
+// Matrix keypads: rows scanned once per tick, keys are port-mapped buttons
+int  button_matrix_init(ButtonMatrix* matrix, uint8_t rows, uint8_t cols,
+                        BtnMatrixDrive drive_row, BtnMatrixRead read_cols, uint8_t port);
+void button_matrix_init_key(Button* handle, ButtonMatrix* matrix, uint8_t row, uint8_t col, uint8_t button_id);
+#endif
+
+#ifdef MULTIBUTTON_CHORDS
+// Chords: evaluated by button_ticks() after all polled buttons are debounced; members
+// of a formed chord do not report individual events until they are idle again
+void button_chord_init(ButtonChord* chord, uint32_t mask);
+void button_chord_attach(ButtonChord* chord, ButtonChordEvent event, BtnChordCallback cb, void* user_data);
+int  button_chord_start(ButtonChord* chord);
+void button_chord_stop(ButtonChord* chord);
+#endif
+
+#ifdef MULTIBUTTON_GROUPS
+// Button groups: the functions above operate on the default group, these on 'group'
+void button_group_init(ButtonGroup* group);
+int  button_group_start(ButtonGroup* group, Button* handle);
+void button_group_stop(ButtonGroup* group, Button* handle);
+void button_group_synchronize(ButtonGroup* group);
+void button_group_ticks(ButtonGroup* group);
+#ifdef MULTIBUTTON_TIME_DRIVEN
+void button_group_ticks_at(ButtonGroup* group, uint32_t now_ms);
+uint16_t button_group_ticks_elapsed(ButtonGroup* group, uint32_t elapsed_ms);
+#endif
+uint16_t button_group_next_deadline(ButtonGroup* group);
+int  button_group_all_idle(ButtonGroup* group);
+#if MULTIBUTTON_MAX_PORTS > 0
+void button_group_port_init(ButtonGroup* group, BtnPortRead read_port);
+int  button_group_matrix_init(ButtonGroup* group, ButtonMatrix* matrix, uint8_t rows, uint8_t cols,
+                              BtnMatrixDrive drive_row, BtnMatrixRead read_cols, uint8_t port);
+#endif
+#ifdef MULTIBUTTON_CHORDS
+int  button_group_chord_start(ButtonGroup* group, ButtonChord* chord);
+void button_group_chord_stop(ButtonGroup* group, ButtonChord* chord);
+#endif
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+uint16_t button_group_dispatch_pending(ButtonGroup* group);
+uint32_t button_group_queue_overflows(ButtonGroup* group);
+#endif
+#if MULTIBUTTON_BATCH_SIZE > 0
+void button_group_set_batch_sink(ButtonGroup* group, BtnBatchSink sink, void* user_data);
+#endif
+#if MULTIBUTTON_TRACE_SIZE > 0
+uint16_t button_group_trace_dump(ButtonGroup* group, uint32_t* out, uint16_t max);
+void button_group_trace_clear(ButtonGroup* group);
+#endif
+#ifdef MULTIBUTTON_STATS
+const ButtonTickStats* button_group_get_tick_stats(ButtonGroup* group);
+void button_group_tick_stats_reset(ButtonGroup* group);
+#endif
+#endif
+
+// Bit-sliced debounce: filter a word of raw levels, returns the debounced levels
+ButtonSlice button_debounce_slice(ButtonDebounce* db, ButtonSlice raw);
+
 // Utility functions
 uint8_t button_get_repeat_count(Button* handle);
 void button_reset(Button* handle);
 int button_is_pressed(Button* handle);
 
+// Button pool functions
+void button_pool_init(ButtonPool* pool, BtnPoolRead read_level);
+int  button_pool_add(ButtonPool* pool, uint8_t active_level);
+void button_pool_attach(ButtonPool* pool, uint16_t index, ButtonEvent event, BtnPoolCallback cb, void* user_data);
+void button_pool_set_profile(ButtonPool* pool, const ButtonProfile* profile);
+void button_pool_ticks(ButtonPool* pool);
+ButtonEvent button_pool_get_event(ButtonPool* pool, uint16_t index);
+uint8_t button_pool_get_repeat_count(ButtonPool* pool, uint16_t index);
+int  button_pool_is_pressed(ButtonPool* pool, uint16_t index);
+
 #ifdef __cplusplus
 }
 #endif
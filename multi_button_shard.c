@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2016 Zibin Zheng <znbin@qq.com>
+ * All rights reserved
+ */
+
+#include "multi_button_shard.h"
+#include <stdlib.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SHARD_THREAD_LOCAL __thread
+#else
+#define SHARD_THREAD_LOCAL _Thread_local
+#endif
+
+// Events one slot can emit in a single tick (press down + repeat)
+#define SHARD_EVENTS_PER_SLOT  2
+
+// Shard ticked by the current worker thread
+static SHARD_THREAD_LOCAL int shard_current = -1;
+
+/**
+  * @brief  Initialize a reusable barrier
+  * @param  barrier: the barrier
+  * @param  parties: number of threads that must arrive before it opens
+  * @retval 0: succeed, -1: failed
+  */
+static int shard_barrier_init(ButtonShardBarrier* barrier, uint32_t parties)
+{
+	if (pthread_mutex_init(&barrier->lock, NULL) != 0) return -1;
+	if (pthread_cond_init(&barrier->cond, NULL) != 0) {
+		pthread_mutex_destroy(&barrier->lock);
+		return -1;
+	}
+	barrier->parties = parties;
+	barrier->waiting = 0;
+	barrier->generation = 0;
+	return 0;
+}
+
+/**
+  * @brief  Wait until all parties arrived at the barrier
+  * @param  barrier: the barrier
+  * @retval None
+  */
+static void shard_barrier_wait(ButtonShardBarrier* barrier)
+{
+	pthread_mutex_lock(&barrier->lock);
+	uint32_t generation = barrier->generation;
+	if (++barrier->waiting == barrier->parties) {
+		barrier->waiting = 0;
+		barrier->generation++;
+		pthread_cond_broadcast(&barrier->cond);
+	} else {
+		while (generation == barrier->generation) {
+			pthread_cond_wait(&barrier->cond, &barrier->lock);
+		}
+	}
+	pthread_mutex_unlock(&barrier->lock);
+}
+
+/**
+  * @brief  Destroy a barrier
+  * @param  barrier: the barrier
+  * @retval None
+  */
+static void shard_barrier_destroy(ButtonShardBarrier* barrier)
+{
+	pthread_cond_destroy(&barrier->cond);
+	pthread_mutex_destroy(&barrier->lock);
+}
+
+/**
+  * @brief  Pool callback recording an event into the shard buffer (worker thread)
+  * @param  pool: the shard's pool
+  * @param  index: slot index
+  * @param  user_data: the shard
+  * @retval None
+  */
+static void shard_record(ButtonPool* pool, uint16_t index, void* user_data)
+{
+	ButtonShard* shard = (ButtonShard*)user_data;
+
+	if (shard->count >= shard->capacity) {
+		shard->dropped++;  // buffer full, drop the event
+		return;
+	}
+	ButtonShardEvent* ev = &shard->events[shard->count++];
+	ev->shard = shard->id;
+	ev->index = index;
+	ev->event = (uint8_t)button_pool_get_event(pool, index);
+	ev->repeat = button_pool_get_repeat_count(pool, index);
+}
+
+/**
+  * @brief  Worker thread: one pool tick per opening of the start barrier
+  * @param  arg: the shard
+  * @retval NULL
+  */
+static void* shard_worker(void* arg)
+{
+	ButtonShard* shard = (ButtonShard*)arg;
+	ButtonShards* group = shard->owner;
+
+	shard_current = shard->id;
+	for (;;) {
+		shard_barrier_wait(&group->start);
+		if (group->stop) break;
+
+		shard->count = 0;
+		button_pool_ticks(shard->pool);
+		shard_barrier_wait(&group->done);
+	}
+	return NULL;
+}
+
+/**
+  * @brief  Set the callback of every event of every slot of a pool
+  * @param  pool: the shard's pool
+  * @param  cb: callback function, NULL to detach
+  * @param  user_data: user context pointer passed to callback
+  * @retval None
+  */
+static void shard_attach(ButtonPool* pool, BtnPoolCallback cb, void* user_data)
+{
+	for (uint16_t slot = 0; slot < pool->count; slot++) {
+		for (uint8_t ev = 0; ev < BTN_EVENT_COUNT; ev++) {
+			button_pool_attach(pool, slot, (ButtonEvent)ev, cb, user_data);
+		}
+	}
+}
+
+/**
+  * @brief  Stop the worker threads started so far and release their buffers
+  * @param  group: the shard group
+  * @retval None
+  */
+static void shard_stop(ButtonShards* group)
+{
+	// Barriers were sized for all shards: stand in for workers that never started
+	pthread_mutex_lock(&group->start.lock);
+	group->start.parties = group->count + 1U;
+	pthread_mutex_unlock(&group->start.lock);
+	group->stop = 1;
+	shard_barrier_wait(&group->start);
+
+	for (uint16_t i = 0; i < group->count; i++) {
+		pthread_join(group->shards[i].thread, NULL);
+		free(group->shards[i].events);
+		group->shards[i].events = NULL;
+	}
+	shard_barrier_destroy(&group->start);
+	shard_barrier_destroy(&group->done);
+	group->count = 0;
+	group->shards = NULL;
+}
+
+/**
+  * @brief  Initialize a shard group and start one worker thread per shard
+  *         Every slot of every pool reports through the sink: the per-slot
+  *         callbacks of the pools are replaced.
+  * @param  group: the shard group struct
+  * @param  shards: shard array, pool set for each entry
+  * @param  count: number of shards
+  * @param  sink: receives the events of each shard after every tick, may be NULL
+  * @param  user_data: user context pointer passed to the sink
+  * @retval 0: succeed, -1: out of resources, -2: invalid parameter
+  */
+int button_shards_init(ButtonShards* group, ButtonShard* shards, uint16_t count,
+                       BtnShardSink sink, void* user_data)
+{
+	if (!group || !shards || !count) return -2;  // invalid parameter
+	for (uint16_t i = 0; i < count; i++) {
+		if (!shards[i].pool) return -2;
+	}
+
+	memset(group, 0, sizeof(ButtonShards));
+	group->shards = shards;
+	group->sink = sink;
+	group->user_data = user_data;
+	if (shard_barrier_init(&group->start, count + 1U) != 0) return -1;
+	if (shard_barrier_init(&group->done, count + 1U) != 0) {
+		shard_barrier_destroy(&group->start);
+		return -1;
+	}
+
+	for (uint16_t i = 0; i < count; i++) {
+		ButtonShard* shard = &shards[i];
+
+		shard->id = i;
+		shard->owner = group;
+		shard->count = 0;
+		shard->dropped = 0;
+		shard->capacity = (uint32_t)shard->pool->count * SHARD_EVENTS_PER_SLOT;
+		shard->events = (ButtonShardEvent*)malloc((shard->capacity ? shard->capacity : 1U) * sizeof(ButtonShardEvent));
+		if (!shard->events || pthread_create(&shard->thread, NULL, shard_worker, shard) != 0) {
+			free(shard->events);
+			shard->events = NULL;
+			shard_stop(group);  // stops the workers started so far, pools untouched
+			return -1;
+		}
+		group->count++;
+	}
+
+	// Only once every worker runs, so a failed init leaves the pool callbacks alone
+	for (uint16_t i = 0; i < count; i++) {
+		shard_attach(shards[i].pool, shard_record, &shards[i]);
+	}
+	return 0;
+}
+
+/**
+  * @brief  Tick all shards once in parallel and deliver their events
+  *         Returns after every shard finished the tick; the sink then runs
+  *         in the calling thread, in shard order.
+  * @param  group: the shard group
+  * @retval None
+  */
+void button_shards_tick(ButtonShards* group)
+{
+	if (!group || !group->count) return;  // parameter validation
+
+	shard_barrier_wait(&group->start);
+	shard_barrier_wait(&group->done);
+
+	if (group->sink) {
+		for (uint16_t i = 0; i < group->count; i++) {
+			ButtonShard* shard = &group->shards[i];
+			if (shard->count) {
+				group->sink(shard->events, shard->count, group->user_data);
+			}
+		}
+	}
+}
+
+/**
+  * @brief  Stop the worker threads and release the event buffers
+  *         The per-slot callbacks installed by button_shards_init() are
+  *         detached, the pools themselves are left to the user.
+  * @param  group: the shard group
+  * @retval None
+  */
+void button_shards_destroy(ButtonShards* group)
+{
+	if (!group || !group->shards) return;  // parameter validation
+
+	for (uint16_t i = 0; i < group->count; i++) {
+		shard_attach(group->shards[i].pool, NULL, NULL);
+	}
+	shard_stop(group);
+}
+
+/**
+  * @brief  Shard ticked by the calling thread
+  *         Lets a pool read function shared by all shards find its inputs.
+  * @param  None
+  * @retval shard index, -1 outside a worker thread
+  */
+int button_shard_current(void)
+{
+	return shard_current;
+}
+
+/**
+  * @brief  Allocate heap storage for a pool
+  *         Call button_pool_init() and button_pool_add() afterwards as usual.
+  * @param  pool: the pool struct
+  * @param  capacity: number of slots
+  * @retval 0: succeed, -1: out of memory, -2: invalid parameter
+  */
+int button_shard_pool_create(ButtonPool* pool, uint16_t capacity)
+{
+	if (!pool || !capacity) return -2;  // invalid parameter
+
+	memset(pool, 0, sizeof(ButtonPool));
+	pool->ticks = (uint16_t*)calloc(capacity, sizeof(uint16_t));
+	pool->flags = (uint8_t*)calloc(capacity, sizeof(uint8_t));
+	pool->repeat = (uint8_t*)calloc(capacity, sizeof(uint8_t));
+	pool->cold = (ButtonPoolCold*)calloc(capacity, sizeof(ButtonPoolCold));
+	if (!pool->ticks || !pool->flags || !pool->repeat || !pool->cold) {
+		button_shard_pool_destroy(pool);
+		return -1;
+	}
+#ifdef MULTIBUTTON_TYPEMATIC
+	pool->hold = (uint16_t*)calloc(capacity, sizeof(uint16_t));
+	if (!pool->hold) {
+		button_shard_pool_destroy(pool);
+		return -1;
+	}
+#endif
+	pool->capacity = capacity;
+	return 0;
+}
+
+/**
+  * @brief  Release pool storage allocated by button_shard_pool_create()
+  * @param  pool: the pool struct
+  * @retval None
+  */
+void button_shard_pool_destroy(ButtonPool* pool)
+{
+	if (!pool) return;  // parameter validation
+
+	free(pool->ticks);
+	free(pool->flags);
+	free(pool->repeat);
+	free(pool->cold);
+#ifdef MULTIBUTTON_TYPEMATIC
+	free(pool->hold);
+#endif
+	memset(pool, 0, sizeof(ButtonPool));
+}
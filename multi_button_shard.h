@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2016 Zibin Zheng <znbin@qq.com>
+ * All rights reserved
+ */
+
+#ifndef MULTI_BUTTON_SHARD_H
+#define MULTI_BUTTON_SHARD_H
+
+// Sharded multi-threaded ticking for large simulated button populations (POSIX hosts only).
+// Buttons are partitioned into shards, each a ButtonPool ticked by its own worker thread.
+// Every tick the workers run in parallel between two barriers, then the events they
+// recorded are delivered from the calling thread in shard order, slot order within a
+// shard, so the event stream does not depend on thread scheduling.
+
+#include "multi_button.h"
+#include <pthread.h>
+
+// Event emitted by a shard slot
+typedef struct {
+	uint16_t shard;                     // shard index
+	uint16_t index;                     // slot index within the shard's pool
+	uint8_t  event;                     // ButtonEvent
+	uint8_t  repeat;                    // repeat counter when the event fired
+} ButtonShardEvent;
+
+// Sink receiving the events of one shard for one tick, called in shard order
+typedef void (*BtnShardSink)(const ButtonShardEvent* events, uint32_t count, void* user_data);
+
+typedef struct _ButtonShards ButtonShards;
+
+// Reusable thread barrier (mutex/condition based, pthread_barrier_t is optional in POSIX)
+typedef struct {
+	pthread_mutex_t   lock;
+	pthread_cond_t    cond;
+	uint32_t          parties;          // threads that must arrive
+	uint32_t          waiting;          // threads arrived in the current generation
+	uint32_t          generation;       // incremented each time the barrier opens
+} ButtonShardBarrier;
+
+// One shard: a pool and the events it recorded during the current tick
+typedef struct {
+	ButtonPool*       pool;             // buttons of this shard (initialized and filled by the user)
+	ButtonShardEvent* events;           // event buffer (allocated by button_shards_init())
+	uint32_t          capacity;         // event buffer size
+	uint32_t          count;            // events recorded this tick
+	uint32_t          dropped;          // events lost because the buffer was full
+	uint16_t          id;               // shard index
+	ButtonShards*     owner;            // shard group
+	pthread_t         thread;           // worker thread
+} ButtonShard;
+
+struct _ButtonShards {
+	ButtonShard*      shards;           // shard array
+	uint16_t          count;            // number of shards (one worker each)
+	volatile int      stop;             // workers exit at the next tick barrier
+	ButtonShardBarrier start;           // releases the workers for one tick
+	ButtonShardBarrier done;            // all shards finished the tick
+	BtnShardSink      sink;             // event sink, may be NULL
+	void*             user_data;        // user context pointer passed to the sink
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shard group lifecycle: pools must be initialized and filled before button_shards_init(),
+// which replaces their slot callbacks; button_shards_destroy() detaches them again
+int  button_shards_init(ButtonShards* group, ButtonShard* shards, uint16_t count,
+                        BtnShardSink sink, void* user_data);
+void button_shards_tick(ButtonShards* group);
+void button_shards_destroy(ButtonShards* group);
+
+// Shard index ticked by the calling worker thread, -1 outside a worker (for pool read functions)
+int  button_shard_current(void);
+
+// Heap-backed pool storage for populations too large for BUTTON_POOL_DEFINE()
+int  button_shard_pool_create(ButtonPool* pool, uint16_t capacity);
+void button_shard_pool_destroy(ButtonPool* pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,10 @@
+# Replay a recorded input file and compare the event stream with the golden output
+execute_process(COMMAND ${REPLAY} ${INPUT} ${OUTPUT} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "replay failed: ${result}")
+endif()
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${OUTPUT} ${GOLDEN} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "replay output ${OUTPUT} differs from ${GOLDEN}")
+endif()
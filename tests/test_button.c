@@ -37,11 +37,80 @@ static uint8_t mock_read_gpio(uint8_t button_id)
     return mock_gpio_value;
 }
 
+#ifdef MULTIBUTTON_CONST_CONFIG
+/* ---- Const config build: emulate button_init/attach/detach ----
+ * Each emulated button gets a writable ButtonConfig from a small round-robin
+ * pool, so the tests below run unchanged against the shared-config layout. */
+#define SHIM_CONFIGS 64
+static ButtonConfig shim_configs[SHIM_CONFIGS];
+static int shim_next = 0;
+
+static ButtonConfig* shim_alloc(void)
+{
+    ButtonConfig* config = &shim_configs[shim_next];
+    shim_next = (shim_next + 1) % SHIM_CONFIGS;
+    memset(config, 0, sizeof(*config));
+    return config;
+}
+
+static ButtonConfig* shim_config(Button* handle)
+{
+    for (int i = 0; i < SHIM_CONFIGS; i++) {
+        if (handle->config == &shim_configs[i]) return &shim_configs[i];
+    }
+    ButtonConfig* config = shim_alloc();
+    *config = *handle->config;
+    button_set_config(handle, config);
+    return config;
+}
+
+static void shim_init(Button* handle, uint8_t(*pin_level)(uint8_t), uint8_t active_level, uint8_t button_id)
+{
+    if (!handle || !pin_level) {
+        button_init_config(handle, NULL, active_level, button_id);
+        return;
+    }
+    ButtonConfig* config = shim_alloc();
+    config->hal_button_level = pin_level;
+    button_init_config(handle, config, active_level, button_id);
+}
+
+static void shim_attach(Button* handle, ButtonEvent event, BtnCallback cb, void* user_data)
+{
+    if (!handle || event >= BTN_EVENT_COUNT) return;
+    ButtonConfig* config = shim_config(handle);
+    config->cb[event] = cb;
+    config->user_data = user_data;
+    button_set_config(handle, config);  /* refresh the subscription mask */
+}
+
+static void shim_detach(Button* handle, ButtonEvent event)
+{
+    if (!handle || event >= BTN_EVENT_COUNT) return;
+    ButtonConfig* config = shim_config(handle);
+    config->cb[event] = NULL;
+    button_set_config(handle, config);
+}
+
+#define button_init   shim_init
+#define button_attach shim_attach
+#define button_detach shim_detach
+#endif
+
+/* ---- Helper: run deferred callbacks (no-op with synchronous dispatch) ---- */
+static void flush_events(void)
+{
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+    button_dispatch_pending();
+#endif
+}
+
 /* ---- Helper: advance N ticks ---- */
 static void tick_n(int n)
 {
     for (int i = 0; i < n; i++) {
         button_ticks();
+        flush_events();
     }
 }
 
@@ -174,9 +243,29 @@ static int test_long_press(void)
 }
 
 /* Test 4: Repeat press count */
+static uint8_t down_repeat[4];
+static uint8_t repeat_repeat[4];
+static int down_calls = 0;
+static int repeat_calls = 0;
+
+static void log_down_repeat(Button* btn, void* user_data)
+{
+    log_press_down(btn, user_data);
+    if (down_calls < 4) down_repeat[down_calls++] = button_get_repeat_count(btn);
+}
+
+static void log_repeat_repeat(Button* btn, void* user_data)
+{
+    log_repeat(btn, user_data);
+    if (repeat_calls < 4) repeat_repeat[repeat_calls++] = button_get_repeat_count(btn);
+}
+
 static int test_repeat_press(void)
 {
     setup_button();
+    button_attach(&test_btn, BTN_PRESS_DOWN, log_down_repeat, NULL);
+    button_attach(&test_btn, BTN_PRESS_REPEAT, log_repeat_repeat, NULL);
+    down_calls = repeat_calls = 0;
 
     for (int i = 0; i < 3; i++) {
         mock_gpio_value = 1;
@@ -190,6 +279,12 @@ static int test_repeat_press(void)
 
     ASSERT(count_event(BTN_PRESS_DOWN) == 3);
     ASSERT(has_event(BTN_PRESS_REPEAT));
+#if MULTIBUTTON_EVENT_QUEUE_SIZE == 0
+    /* PRESS_DOWN sees the count before the press, PRESS_REPEAT after it */
+    ASSERT(down_calls == 3 && repeat_calls == 2);
+    ASSERT(down_repeat[1] == 1 && repeat_repeat[0] == 2);
+    ASSERT(down_repeat[2] == 2 && repeat_repeat[1] == 3);
+#endif
 
     teardown_button();
     return 0;
@@ -487,6 +582,1601 @@ static int test_rapid_press_release(void)
     return 0;
 }
 
+/* Test 17: Port-mapped buttons share one port read per tick */
+static uint32_t mock_port_value = 0;
+
+static uint8_t mock_read_port_bit(uint8_t button_id)
+{
+    return (mock_port_value >> button_id) & 1U;
+}
+
+#if MULTIBUTTON_MAX_PORTS > 0
+static int mock_port_reads = 0;
+
+static uint32_t mock_read_port(uint8_t port)
+{
+    (void)port;
+    mock_port_reads++;
+    return mock_port_value;
+}
+
+static int test_port_mapped(void)
+{
+    Button port_a, port_b;
+
+    mock_port_value = 0;
+    button_port_init(mock_read_port);
+    button_init_port(&port_a, 0, 1UL << 3, 1, 20);
+    button_init_port(&port_b, 0, 1UL << 17, 1, 21);
+    button_start(&port_a);
+    button_start(&port_b);
+
+    /* Only pin 17 goes high */
+    mock_port_value = 1UL << 17;
+    mock_port_reads = 0;
+    tick_n(DEBOUNCE_TICKS + 5);
+
+    ASSERT(mock_port_reads == DEBOUNCE_TICKS + 5);  /* one read per tick, not per button */
+    ASSERT(button_is_pressed(&port_a) == 0);
+    ASSERT(button_is_pressed(&port_b) == 1);
+    ASSERT(button_get_event(&port_b) == BTN_PRESS_DOWN);
+
+    /* Initializing another button on the held pin leaves its debounce state alone */
+    Button port_c;
+    button_init_port(&port_c, 0, 1UL << 17, 1, 22);
+    tick_n(DEBOUNCE_TICKS + 5);
+    ASSERT(button_is_pressed(&port_b) == 1);
+    ASSERT(button_get_repeat_count(&port_b) == 1);
+
+    /* Restarting the held button seeds its pin from the next tick: no release in between */
+    button_stop(&port_b);
+    button_start(&port_b);
+    tick_n(DEBOUNCE_TICKS + 5);
+    ASSERT(button_is_pressed(&port_b) == 1);
+    ASSERT(button_get_event(&port_b) != BTN_PRESS_UP);
+
+    button_stop(&port_a);
+    button_stop(&port_b);
+    button_port_init(NULL);
+    return 0;
+}
+
+/* Test 18: Bit-sliced port debounce matches per-button debounce */
+static int test_slice_debounce_equivalence(void)
+{
+    Button sliced[8], scalar[8];
+    uint32_t seed = 12345;
+
+    mock_port_value = 0;
+    button_port_init(mock_read_port);
+    for (int i = 0; i < 8; i++) {
+        button_init_port(&sliced[i], 1, 1UL << i, (uint8_t)(i & 1), (uint8_t)i);
+        button_init(&scalar[i], mock_read_port_bit, (uint8_t)(i & 1), (uint8_t)i);
+        button_start(&sliced[i]);
+        button_start(&scalar[i]);
+    }
+
+    /* Random bouncy input: each bit flips with varying probability */
+    for (int t = 0; t < 5000; t++) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t flips = (seed >> 8) & ((t & 256) ? 0xFFu : 0x11u);
+        if ((t & 512) || (t & 7) == 0) mock_port_value ^= flips;
+        button_ticks();
+        for (int i = 0; i < 8; i++) {
+            ASSERT(sliced[i].button_level == scalar[i].button_level);
+            ASSERT(button_get_event(&sliced[i]) == button_get_event(&scalar[i]));
+        }
+    }
+
+    for (int i = 0; i < 8; i++) {
+        button_stop(&sliced[i]);
+        button_stop(&scalar[i]);
+    }
+    button_port_init(NULL);
+    mock_port_value = 0;
+    return 0;
+}
+#endif
+
+/* Test 19: ButtonPool produces the same events as list buttons */
+BUTTON_POOL_DEFINE(test_pool, 8);
+static int pool_click_count = 0;
+
+static uint8_t mock_read_pool(uint16_t index)
+{
+    return (mock_port_value >> index) & 1U;
+}
+
+static void pool_on_click(ButtonPool* pool, uint16_t index, void* user_data)
+{
+    (void)pool; (void)index; (void)user_data;
+    pool_click_count++;
+}
+
+#if MULTIBUTTON_EVENT_QUEUE_SIZE == 0
+/* Repeat count seen by the last callback of each pool slot and list button */
+static uint8_t pool_cb_repeat[8];
+static uint8_t list_cb_repeat[8];
+
+static void pool_on_press(ButtonPool* pool, uint16_t index, void* user_data)
+{
+    (void)user_data;
+    pool_cb_repeat[index] = button_pool_get_repeat_count(pool, index);
+}
+
+static void list_on_press(Button* btn, void* user_data)
+{
+    (void)user_data;
+    list_cb_repeat[btn->button_id] = button_get_repeat_count(btn);
+}
+#endif
+
+static int test_pool_equivalence(void)
+{
+    Button listed[8];
+    uint32_t seed = 777;
+
+    mock_port_value = 0;
+    pool_click_count = 0;
+    button_pool_init(&test_pool, mock_read_pool);
+    for (int i = 0; i < 8; i++) {
+        ASSERT(button_pool_add(&test_pool, (uint8_t)(i & 1)) == i);
+        button_pool_attach(&test_pool, (uint16_t)i, BTN_SINGLE_CLICK, pool_on_click, NULL);
+        button_init(&listed[i], mock_read_port_bit, (uint8_t)(i & 1), (uint8_t)i);
+#if MULTIBUTTON_EVENT_QUEUE_SIZE == 0
+        /* Callbacks see the same repeat count: old one on PRESS_DOWN, counted one on PRESS_REPEAT */
+        button_pool_attach(&test_pool, (uint16_t)i, BTN_PRESS_DOWN, pool_on_press, NULL);
+        button_pool_attach(&test_pool, (uint16_t)i, BTN_PRESS_REPEAT, pool_on_press, NULL);
+        button_attach(&listed[i], BTN_PRESS_DOWN, list_on_press, NULL);
+        button_attach(&listed[i], BTN_PRESS_REPEAT, list_on_press, NULL);
+        pool_cb_repeat[i] = list_cb_repeat[i] = 0;
+#endif
+        button_start(&listed[i]);
+    }
+    ASSERT(button_pool_add(&test_pool, 1) == -1);  /* pool full */
+
+    for (int t = 0; t < 20000; t++) {
+        seed = seed * 1103515245u + 12345u;
+        if ((t % 40) == 0) mock_port_value ^= (seed >> 8) & 0xFFu;
+        button_ticks();
+        button_pool_ticks(&test_pool);
+        for (int i = 0; i < 8; i++) {
+            ASSERT(button_pool_get_event(&test_pool, (uint16_t)i) == button_get_event(&listed[i]));
+            ASSERT(button_pool_get_repeat_count(&test_pool, (uint16_t)i) == button_get_repeat_count(&listed[i]));
+            ASSERT(button_pool_is_pressed(&test_pool, (uint16_t)i) == button_is_pressed(&listed[i]));
+#if MULTIBUTTON_EVENT_QUEUE_SIZE == 0
+            ASSERT(pool_cb_repeat[i] == list_cb_repeat[i]);
+#endif
+        }
+    }
+    ASSERT(pool_click_count > 0);
+
+    for (int i = 0; i < 8; i++) {
+        button_stop(&listed[i]);
+    }
+    mock_port_value = 0;
+    return 0;
+}
+
+/* Test 20: start/stop keeps the list consistent in any order */
+static int test_start_stop_order(void)
+{
+    Button many[5];
+
+    mock_gpio_value = 0;
+    reset_event_log();
+    for (int i = 0; i < 5; i++) {
+        button_init(&many[i], mock_read_gpio, 1, (uint8_t)(30 + i));
+        button_attach(&many[i], BTN_PRESS_DOWN, log_press_down, NULL);
+        ASSERT(button_start(&many[i]) == 0);
+    }
+
+    button_stop(&many[2]);  /* middle */
+    button_stop(&many[4]);  /* head (last started) */
+    button_stop(&many[0]);  /* tail */
+    button_stop(&many[0]);  /* not in list: no-op */
+    ASSERT(button_start(&many[1]) == -1);
+    ASSERT(button_start(&many[4]) == 0);
+
+    mock_gpio_value = 1;
+    tick_n(DEBOUNCE_TICKS + 2);
+    ASSERT(count_event(BTN_PRESS_DOWN) == 3);  /* buttons 1, 3 and 4 */
+
+    for (int i = 0; i < 5; i++) {
+        button_stop(&many[i]);
+    }
+    reset_event_log();
+    tick_n(5);
+    ASSERT(event_count == 0);
+
+    mock_gpio_value = 0;
+    return 0;
+}
+
+/* Test 21: button_next_deadline() predicts timeouts, all-idle indicator */
+static int test_next_deadline(void)
+{
+    setup_button();
+    ASSERT(button_all_idle() == 1);
+    ASSERT(button_next_deadline() == BUTTON_DEADLINE_NONE);
+
+    /* Debouncing needs every tick */
+    mock_gpio_value = 1;
+    tick_n(1);
+    ASSERT(button_next_deadline() == 1);
+    ASSERT(button_all_idle() == 0);
+    tick_n(DEBOUNCE_TICKS + 2);
+
+    /* Held: the deadline is the long press threshold */
+    uint16_t d = button_next_deadline();
+    ASSERT(d > 1 && d != BUTTON_DEADLINE_NONE);
+    reset_event_log();
+    tick_n(d - 1);
+    ASSERT(event_count == 0);
+    tick_n(1);
+    ASSERT(has_event(BTN_LONG_PRESS_START));
+
+    /* Release from long hold, then a click: deadline is the click timeout */
+    mock_gpio_value = 0;
+    tick_n(DEBOUNCE_TICKS + 2);
+    mock_gpio_value = 1;
+    tick_n(DEBOUNCE_TICKS + 2);
+    mock_gpio_value = 0;
+    tick_n(DEBOUNCE_TICKS + 2);
+    d = button_next_deadline();
+    ASSERT(d > 1 && d != BUTTON_DEADLINE_NONE);
+    reset_event_log();
+    tick_n(d - 1);
+    ASSERT(event_count == 0);
+    tick_n(1);
+    ASSERT(has_event(BTN_SINGLE_CLICK));
+    ASSERT(button_all_idle() == 1);
+
+    teardown_button();
+    return 0;
+}
+
+#ifdef MULTIBUTTON_TIME_DRIVEN
+/* Helpers for reference comparisons: random bouncy input and per-tick snapshots */
+#define REF_TICKS 20000
+static uint8_t ref_trace[REF_TICKS][3];
+
+static uint8_t random_level(uint32_t* seed, uint8_t level, uint32_t k)
+{
+    *seed = *seed * 1103515245u + 12345u;
+    uint32_t r = (*seed >> 16) % 100;
+    return (r < ((k & 2048) ? 40u : 3u)) ? !level : level;
+}
+
+static void record_ref(uint32_t k, Button* btn)
+{
+    ref_trace[k][0] = (uint8_t)button_get_event(btn);
+    ref_trace[k][1] = button_get_repeat_count(btn);
+    ref_trace[k][2] = (uint8_t)button_is_pressed(btn);
+}
+
+static int matches_ref(uint32_t k, Button* btn)
+{
+    return ref_trace[k][0] == (uint8_t)button_get_event(btn)
+        && ref_trace[k][1] == button_get_repeat_count(btn)
+        && ref_trace[k][2] == (uint8_t)button_is_pressed(btn);
+}
+
+/* Record a polled button driven by button_ticks() as the reference */
+static void record_polled_reference(uint32_t seed)
+{
+    Button poll_btn;
+    uint8_t level = 0;
+
+    mock_gpio_value = 0;
+    button_init(&poll_btn, mock_read_gpio, 1, 41);
+    button_start(&poll_btn);
+    for (uint32_t k = 1; k < REF_TICKS; k++) {
+        level = random_level(&seed, level, k);
+        mock_gpio_value = level;
+        button_ticks();
+        record_ref(k, &poll_btn);
+    }
+    button_stop(&poll_btn);
+    mock_gpio_value = 0;
+}
+
+/* Test 22: Edge-driven button matches a polled button on the same input */
+static int test_edge_equivalence(void)
+{
+    Button edge_btn;
+    uint32_t seed = 4242;
+    uint8_t level = 0;
+
+    record_polled_reference(seed);
+
+    button_init_edge(&edge_btn, 1, 40);
+    button_start(&edge_btn);
+    for (uint32_t k = 1; k < REF_TICKS; k++) {
+        uint8_t next = random_level(&seed, level, k);
+        if (next != level) {
+            /* Edge happens just before tick k samples it */
+            level = next;
+            button_on_edge(&edge_btn, level, k * TICKS_INTERVAL - 1);
+        }
+        button_ticks_at(k * TICKS_INTERVAL);
+        ASSERT(matches_ref(k, &edge_btn));
+    }
+
+    button_stop(&edge_btn);
+    return 0;
+}
+
+/* Test 23: Edge-driven click with bounce, advanced only on demand */
+static int test_edge_click(void)
+{
+    Button edge_btn;
+
+    reset_event_log();
+    button_init_edge(&edge_btn, 0, 42);  /* active low */
+    button_attach(&edge_btn, BTN_PRESS_DOWN, log_press_down, NULL);
+    button_attach(&edge_btn, BTN_PRESS_UP, log_press_up, NULL);
+    button_attach(&edge_btn, BTN_SINGLE_CLICK, log_single_click, NULL);
+    button_attach(&edge_btn, BTN_LONG_PRESS_START, log_long_start, NULL);
+    button_start(&edge_btn);
+
+    /* Bouncy press: only the last edge survives the debounce window */
+    button_on_edge(&edge_btn, 0, 1000);
+    button_on_edge(&edge_btn, 1, 1001);
+    button_on_edge(&edge_btn, 0, 1003);
+    button_ticks_at(1003 + DEBOUNCE_MS - 1);
+    flush_events();
+    ASSERT(event_count == 0);
+    ASSERT(button_next_deadline() != BUTTON_DEADLINE_NONE);
+    button_ticks_at(1003 + DEBOUNCE_MS + TICKS_INTERVAL);
+    flush_events();
+    ASSERT(has_event(BTN_PRESS_DOWN));
+
+    /* Release; a single late call fires the click timeout */
+    button_on_edge(&edge_btn, 1, 1200);
+    button_ticks_at(1200 + DEBOUNCE_MS + TICKS_INTERVAL * (SHORT_TICKS + 5));
+    flush_events();
+    ASSERT(has_event(BTN_PRESS_UP));
+    ASSERT(has_event(BTN_SINGLE_CLICK));
+    ASSERT(!has_event(BTN_LONG_PRESS_START));
+    ASSERT(button_all_idle() == 1);
+
+    button_stop(&edge_btn);
+    return 0;
+}
+
+/* Test 24: button_ticks_at() at the nominal rate matches button_ticks() */
+static int test_ticks_at_equivalence(void)
+{
+    Button time_btn;
+    uint32_t seed = 99;
+    uint8_t level = 0;
+
+    record_polled_reference(seed);
+
+    mock_gpio_value = 0;
+    button_init(&time_btn, mock_read_gpio, 1, 43);
+    button_start(&time_btn);
+    for (uint32_t k = 1; k < REF_TICKS; k++) {
+        level = random_level(&seed, level, k);
+        mock_gpio_value = level;
+        button_ticks_at(k * TICKS_INTERVAL + 2);  /* sub-tick offset is ignored */
+        ASSERT(matches_ref(k, &time_btn));
+    }
+
+    button_stop(&time_btn);
+    mock_gpio_value = 0;
+    return 0;
+}
+
+/* Test 25: button_ticks_at() keeps long press and click timing with late calls */
+static int test_ticks_at_jitter(void)
+{
+    uint32_t now = 100000;
+
+    setup_button();
+
+    /* Hold for 1.5 s, called every 37 ms: exactly one long press start */
+    mock_gpio_value = 1;
+    for (uint32_t t = 0; t <= 1500; t += 37) {
+        button_ticks_at(now + t);
+        flush_events();
+        if (t < 900) ASSERT(!has_event(BTN_LONG_PRESS_START));
+    }
+    ASSERT(count_event(BTN_LONG_PRESS_START) == 1);
+    ASSERT(has_event(BTN_LONG_PRESS_HOLD));
+    now += 1500;
+
+    /* Release, then a 150 ms click sampled every 45 ms */
+    mock_gpio_value = 0;
+    button_ticks_at(now += 45);
+    button_ticks_at(now += 45);
+    reset_event_log();
+    mock_gpio_value = 1;
+    for (int i = 0; i < 4; i++) button_ticks_at(now += 45);
+    mock_gpio_value = 0;
+    for (int i = 0; i < 3; i++) button_ticks_at(now += 45);
+
+    /* One very late call covers the whole click timeout */
+    button_ticks_at(now += 2000);
+    flush_events();
+    ASSERT(count_event(BTN_PRESS_DOWN) == 1);
+    ASSERT(has_event(BTN_SINGLE_CLICK));
+    ASSERT(!has_event(BTN_LONG_PRESS_START));
+
+    teardown_button();
+    return 0;
+}
+
+/* Test 26: button_ticks_at() at a slow rate rejects a glitch seen by one sample */
+static int test_ticks_at_glitch(void)
+{
+    uint32_t now = 200000;
+
+    setup_button();
+    button_ticks_at(now);
+
+    /* Called every 20 ms, one sample sees the button pressed */
+    for (int i = 0; i < 5; i++) {
+        mock_gpio_value = (i == 2);
+        button_ticks_at(now += 20);
+    }
+    button_ticks_at(now += 2000);
+    flush_events();
+    ASSERT(event_count == 0);
+    ASSERT(button_all_idle() == 1);
+
+    /* A second sample 20 ms later confirms a real press */
+    mock_gpio_value = 1;
+    button_ticks_at(now += 20);
+    flush_events();
+    ASSERT(event_count == 0);
+    button_ticks_at(now += 20);
+    flush_events();
+    ASSERT(count_event(BTN_PRESS_DOWN) == 1);
+    mock_gpio_value = 0;
+    button_ticks_at(now += 20);
+    button_ticks_at(now += 20);
+    button_ticks_at(now += 2000);
+    flush_events();
+    ASSERT(has_event(BTN_PRESS_UP));
+    ASSERT(has_event(BTN_SINGLE_CLICK));
+
+    teardown_button();
+    return 0;
+}
+
+/* Test 27: Time-driven buttons react after an idle gap of 2^31 ms or more */
+static int test_ticks_at_long_idle(void)
+{
+    const uint32_t days25 = 25UL * 24 * 3600 * 1000;
+    Button edge_btn;
+    uint32_t now;
+
+    /* Edge button idle for 25 days, then pressed */
+    reset_event_log();
+    button_init_edge(&edge_btn, 1, 44);
+    button_attach(&edge_btn, BTN_PRESS_DOWN, log_press_down, NULL);
+    button_start(&edge_btn);
+    button_ticks_at(1000);
+    now = 1000 + days25;
+    button_on_edge(&edge_btn, 1, now);
+    button_ticks_at(now + DEBOUNCE_MS + TICKS_INTERVAL);
+    flush_events();
+    ASSERT(count_event(BTN_PRESS_DOWN) == 1);
+    button_stop(&edge_btn);
+
+    /* Pin button first ticked at a timestamp 2^31 ms after its zero stamp */
+    setup_button();
+    now = 0x80000010UL;
+    button_ticks_at(now);
+    mock_gpio_value = 1;
+    for (int i = 0; i < DEBOUNCE_TICKS + 1; i++) {
+        button_ticks_at(now += TICKS_INTERVAL);
+    }
+    flush_events();
+    ASSERT(count_event(BTN_PRESS_DOWN) == 1);
+    mock_gpio_value = 0;
+    for (int i = 0; i < DEBOUNCE_TICKS + 1; i++) {
+        button_ticks_at(now += TICKS_INTERVAL);
+    }
+    button_ticks_at(now += 1000);
+    flush_events();
+    ASSERT(has_event(BTN_SINGLE_CLICK));
+
+    teardown_button();
+    return 0;
+}
+#endif
+
+/* Test 28: Buttons initialized from one shared configuration */
+static const ButtonConfig shared_config = {
+    mock_read_gpio,
+    { [BTN_PRESS_DOWN] = log_press_down, [BTN_SINGLE_CLICK] = log_single_click },
+    NULL
+};
+
+static int test_shared_config(void)
+{
+    Button a, b;
+
+    reset_event_log();
+    mock_gpio_value = 0;
+    button_init_config(&a, &shared_config, 1, 70);
+    button_init_config(&b, &shared_config, 1, 71);
+    button_start(&a);
+    button_start(&b);
+
+    /* Both polled buttons report through the shared callbacks */
+    mock_gpio_value = 1;
+    tick_n(DEBOUNCE_TICKS + 1);
+    ASSERT(count_event(BTN_PRESS_DOWN) == 2);
+    mock_gpio_value = 0;
+    tick_n(DEBOUNCE_TICKS + SHORT_TICKS + 2);
+    ASSERT(count_event(BTN_SINGLE_CLICK) == 2);
+    button_stop(&a);
+    button_stop(&b);
+
+#ifdef MULTIBUTTON_TIME_DRIVEN
+    /* Edge buttons take callbacks from the configuration, not its HAL read */
+    Button e;
+    button_init_edge(&e, 1, 72);
+    button_set_config(&e, &shared_config);
+    reset_event_log();
+    button_start(&e);
+    button_on_edge(&e, 1, 1000);
+    button_on_edge(&e, 0, 1100);
+    button_ticks_at(2000);
+    flush_events();
+    ASSERT(count_event(BTN_PRESS_DOWN) == 1);
+    ASSERT(count_event(BTN_SINGLE_CLICK) == 1);
+    button_stop(&e);
+#endif
+
+    /* Invalid configurations are rejected */
+    button_init_config(NULL, &shared_config, 1, 73);
+    button_init_config(&a, NULL, 1, 73);
+    button_set_config(NULL, &shared_config);
+    return 0;
+}
+
+#ifdef MULTIBUTTON_PROFILES
+/* Test 29: Per-button timing profiles */
+static const ButtonProfile fast_profile = { 10, 20, 1, 0, 0, 0, 0 };
+static const ButtonProfile power_profile = { SHORT_TICKS, 3 * LONG_TICKS, 5, 0, 0, 0, 0 };
+static int long_start_tick[3];
+static int profile_tick = 0;
+
+static void log_long_start_tick(Button* btn, void* user_data)
+{
+    (void)user_data;
+    long_start_tick[btn->button_id - 80] = profile_tick;
+}
+
+static int pool_long_tick = 0;
+
+static uint8_t mock_read_gpio_slot(uint16_t index)
+{
+    (void)index;
+    return mock_gpio_value;
+}
+
+static void pool_on_long(ButtonPool* pool, uint16_t index, void* user_data)
+{
+    (void)pool; (void)index; (void)user_data;
+    pool_long_tick = profile_tick;
+}
+
+BUTTON_POOL_DEFINE(profile_pool, 1);
+
+static int test_profiles(void)
+{
+    Button btns[3];
+
+    mock_gpio_value = 0;
+    for (int i = 0; i < 3; i++) {
+        button_init(&btns[i], mock_read_gpio, 1, (uint8_t)(80 + i));
+        button_attach(&btns[i], BTN_LONG_PRESS_START, log_long_start_tick, NULL);
+        long_start_tick[i] = 0;
+    }
+    button_set_profile(&btns[1], &fast_profile);
+    button_set_profile(&btns[2], &power_profile);
+    ASSERT(btns[0].profile == &button_profile_default);
+
+    /* Invalid profiles are rejected */
+    static const ButtonProfile bad_profile = { 10, 20, 8, 0, 0, 0, 0 };
+    button_set_profile(&btns[1], &bad_profile);
+    button_set_profile(&btns[1], NULL);
+    button_set_profile(NULL, &fast_profile);
+    ASSERT(btns[1].profile == &fast_profile);
+
+    button_pool_init(&profile_pool, mock_read_gpio_slot);
+    button_pool_set_profile(&profile_pool, &fast_profile);
+    ASSERT(button_pool_add(&profile_pool, 1) == 0);
+    button_pool_attach(&profile_pool, 0, BTN_LONG_PRESS_START, pool_on_long, NULL);
+    pool_long_tick = 0;
+
+    for (int i = 0; i < 3; i++) {
+        button_start(&btns[i]);
+    }
+
+    /* Long press fires after debounce_ticks + long_ticks + 1 ticks of holding */
+    mock_gpio_value = 1;
+    for (profile_tick = 1; profile_tick <= 3 * LONG_TICKS + 10; profile_tick++) {
+        button_ticks();
+        button_pool_ticks(&profile_pool);
+        flush_events();
+    }
+    ASSERT(long_start_tick[0] == DEBOUNCE_TICKS + LONG_TICKS + 1);
+    ASSERT(long_start_tick[1] == 1 + 20 + 1);
+    ASSERT(long_start_tick[2] == 5 + 3 * LONG_TICKS + 1);
+    ASSERT(pool_long_tick == long_start_tick[1]);
+
+    for (int i = 0; i < 3; i++) {
+        button_stop(&btns[i]);
+    }
+    mock_gpio_value = 0;
+    return 0;
+}
+#endif
+
+#ifdef MULTIBUTTON_GESTURES
+/* Test 30: Press-sequence gestures */
+static int gesture_hits[3];
+
+static void on_triple(Button* btn, void* user_data)     { (void)btn; (void)user_data; gesture_hits[0]++; }
+static void on_click_hold(Button* btn, void* user_data) { (void)btn; (void)user_data; gesture_hits[1]++; }
+static void on_hold(Button* btn, void* user_data)       { (void)btn; (void)user_data; gesture_hits[2]++; }
+
+static const ButtonGesture gesture_table[] = {
+    { 3, 0, on_triple },
+    { 2, 1, on_click_hold },
+    { 1, 1, on_hold },
+    { 0, 0, NULL }
+};
+
+static void click(int hold_ticks)
+{
+    mock_gpio_value = 1;
+    tick_n(DEBOUNCE_TICKS + hold_ticks);
+    mock_gpio_value = 0;
+    tick_n(DEBOUNCE_TICKS + 5);
+}
+
+static int gestures_after(int clicks, int hold)
+{
+    setup_button();
+    button_set_gestures(&test_btn, gesture_table);
+    memset(gesture_hits, 0, sizeof(gesture_hits));
+    for (int i = 0; i < clicks; i++) {
+        click(5);
+    }
+    if (hold) {
+        click(SHORT_TICKS + LONG_TICKS + 10);
+    }
+    tick_n(SHORT_TICKS + 20);
+    teardown_button();
+    return gesture_hits[0] * 100 + gesture_hits[1] * 10 + gesture_hits[2];
+}
+
+static int test_gestures(void)
+{
+    ASSERT(gestures_after(3, 0) == 100);
+    ASSERT(gestures_after(1, 1) == 10);
+    ASSERT(gestures_after(0, 1) == 1);
+
+    /* No matching entry: only the regular events fire */
+    ASSERT(gestures_after(2, 0) == 0);
+    ASSERT(count_event(BTN_DOUBLE_CLICK) == 1);
+    ASSERT(gestures_after(4, 0) == 0);
+
+    /* Gestures disabled */
+    setup_button();
+    button_set_gestures(&test_btn, NULL);
+    button_set_gestures(NULL, gesture_table);
+    memset(gesture_hits, 0, sizeof(gesture_hits));
+    for (int i = 0; i < 3; i++) {
+        click(5);
+    }
+    tick_n(SHORT_TICKS + 20);
+    teardown_button();
+    ASSERT(gesture_hits[0] == 0);
+    return 0;
+}
+#endif
+
+#ifdef MULTIBUTTON_CHORDS
+/* Test 31: Chord detection and member event suppression, also in time-driven passes */
+static int chord_events[BTN_CHORD_EVENT_COUNT];
+static int member_events = 0;
+static int member_clicks = 0;
+
+static void on_chord_press(ButtonChord* chord, void* user_data)   { (void)chord; (void)user_data; chord_events[BTN_CHORD_PRESS]++; }
+static void on_chord_release(ButtonChord* chord, void* user_data) { (void)chord; (void)user_data; chord_events[BTN_CHORD_RELEASE]++; }
+static void on_chord_long(ButtonChord* chord, void* user_data)    { (void)chord; (void)user_data; chord_events[BTN_CHORD_LONG_PRESS]++; }
+static void on_member_event(Button* btn, void* user_data)         { (void)btn; (void)user_data; member_events++; }
+static void on_member_click(Button* btn, void* user_data)         { (void)btn; (void)user_data; member_clicks++; }
+
+static int chord_stop_presses = 0;
+
+static void on_chord_stop_self(ButtonChord* chord, void* user_data)
+{
+    (void)user_data;
+    chord_stop_presses++;
+    button_chord_stop(chord);  /* the pass carries on to the chords behind it */
+}
+
+static int test_chords(void)
+{
+    Button a, b;
+    ButtonChord ab;
+
+    mock_port_value = 0;
+    button_init(&a, mock_read_port_bit, 1, 2);
+    button_init(&b, mock_read_port_bit, 1, 3);
+    for (int ev = 0; ev < BTN_EVENT_COUNT; ev++) {
+        button_attach(&a, (ButtonEvent)ev, on_member_event, NULL);
+        button_attach(&b, (ButtonEvent)ev, on_member_event, NULL);
+    }
+    button_attach(&a, BTN_SINGLE_CLICK, on_member_click, NULL);
+    button_start(&a);
+    button_start(&b);
+
+    button_chord_init(&ab, (1UL << 2) | (1UL << 3));
+    button_chord_attach(&ab, BTN_CHORD_PRESS, on_chord_press, NULL);
+    button_chord_attach(&ab, BTN_CHORD_RELEASE, on_chord_release, NULL);
+    button_chord_attach(&ab, BTN_CHORD_LONG_PRESS, on_chord_long, NULL);
+    ASSERT(button_chord_start(&ab) == 0);
+    ASSERT(button_chord_start(&ab) == -1);
+    ASSERT(button_chord_start(NULL) == -2);
+    memset(chord_events, 0, sizeof(chord_events));
+    member_events = member_clicks = 0;
+
+    /* Both pressed in the same tick: only chord events */
+    mock_port_value = (1UL << 2) | (1UL << 3);
+    tick_n(DEBOUNCE_TICKS + 5);
+    ASSERT(chord_events[BTN_CHORD_PRESS] == 1);
+    mock_port_value = 0;
+    tick_n(DEBOUNCE_TICKS + SHORT_TICKS + 5);
+    ASSERT(chord_events[BTN_CHORD_RELEASE] == 1);
+    ASSERT(chord_events[BTN_CHORD_LONG_PRESS] == 0);
+    ASSERT(member_events == 0);
+
+    /* A alone clicks normally once the members are idle again */
+    mock_port_value = 1UL << 2;
+    tick_n(DEBOUNCE_TICKS + 5);
+    mock_port_value = 0;
+    tick_n(DEBOUNCE_TICKS + SHORT_TICKS + 5);
+    ASSERT(member_clicks == 1);
+    ASSERT(chord_events[BTN_CHORD_PRESS] == 1);
+
+    /* A first, then B: the chord forms on B; long press fires once */
+    member_events = member_clicks = 0;
+    mock_port_value = 1UL << 2;
+    tick_n(DEBOUNCE_TICKS + 2);
+    ASSERT(member_events == 1);  /* A's press down precedes the chord */
+    mock_port_value = (1UL << 2) | (1UL << 3);
+    tick_n(DEBOUNCE_TICKS + LONG_TICKS + 10);
+    ASSERT(chord_events[BTN_CHORD_PRESS] == 2);
+    ASSERT(chord_events[BTN_CHORD_LONG_PRESS] == 1);
+    mock_port_value = 0;
+    tick_n(DEBOUNCE_TICKS + SHORT_TICKS + 5);
+    ASSERT(chord_events[BTN_CHORD_RELEASE] == 2);
+    ASSERT(member_events == 1);
+    ASSERT(member_clicks == 0);
+
+    /* A chord stopping itself from its callback: the chord behind it is evaluated in the same tick */
+    ButtonChord first;
+    button_chord_init(&first, (1UL << 2) | (1UL << 3));
+    button_chord_attach(&first, BTN_CHORD_PRESS, on_chord_stop_self, NULL);
+    ASSERT(button_chord_start(&first) == 0);  /* chord list: first, ab */
+    chord_stop_presses = 0;
+    mock_port_value = (1UL << 2) | (1UL << 3);
+    for (int t = 0; t < DEBOUNCE_TICKS + 5; t++) {
+        tick_n(1);
+        ASSERT(chord_events[BTN_CHORD_PRESS] - 2 == chord_stop_presses);
+    }
+    ASSERT(chord_stop_presses == 1);
+    button_synchronize();  /* no tick pass can still stand on it */
+    ASSERT(first.group == NULL);
+    ASSERT(button_chord_start(&first) == 0);
+    button_chord_stop(&first);
+    mock_port_value = 0;
+    tick_n(DEBOUNCE_TICKS + SHORT_TICKS + 5);
+
+#ifdef MULTIBUTTON_PROFILES
+    /* The long press waits for the member with the longest long_ticks */
+    static const ButtonProfile slow_profile = { SHORT_TICKS, 2 * LONG_TICKS, DEBOUNCE_TICKS, 0, 0, 0, 0 };
+    button_set_profile(&b, &slow_profile);
+    memset(chord_events, 0, sizeof(chord_events));
+    mock_port_value = (1UL << 2) | (1UL << 3);
+    tick_n(DEBOUNCE_TICKS + LONG_TICKS + 10);
+    ASSERT(chord_events[BTN_CHORD_PRESS] == 1);
+    ASSERT(chord_events[BTN_CHORD_LONG_PRESS] == 0);
+    tick_n(LONG_TICKS);
+    ASSERT(chord_events[BTN_CHORD_LONG_PRESS] == 1);
+    mock_port_value = 0;
+    tick_n(DEBOUNCE_TICKS + SHORT_TICKS + 5);
+    ASSERT(chord_events[BTN_CHORD_RELEASE] == 1);
+    button_set_profile(&b, &button_profile_default);
+#endif
+
+#ifdef MULTIBUTTON_TIME_DRIVEN
+    /* button_ticks_at() evaluates chords too; a coalesced call counts every elapsed tick */
+    uint32_t now = 50000;
+    memset(chord_events, 0, sizeof(chord_events));
+    member_events = 0;
+    button_ticks_at(now);
+    mock_port_value = (1UL << 2) | (1UL << 3);
+    for (int t = 0; t < DEBOUNCE_TICKS + 2; t++) {
+        now += TICKS_INTERVAL;
+        button_ticks_at(now);
+    }
+    flush_events();
+    ASSERT(chord_events[BTN_CHORD_PRESS] == 1);
+    now += TICKS_INTERVAL * (LONG_TICKS + 5);
+    button_ticks_at(now);
+    flush_events();
+    ASSERT(chord_events[BTN_CHORD_LONG_PRESS] == 1);
+    mock_port_value = 0;
+    for (int t = 0; t < DEBOUNCE_TICKS + 2; t++) {
+        now += TICKS_INTERVAL;
+        button_ticks_at(now);
+    }
+    now += TICKS_INTERVAL * (SHORT_TICKS + 5);
+    button_ticks_at(now);
+    flush_events();
+    ASSERT(chord_events[BTN_CHORD_RELEASE] == 1);
+    ASSERT(member_events == 0);
+#endif
+
+    button_chord_stop(&ab);
+    button_stop(&a);
+    button_stop(&b);
+    return 0;
+}
+#endif
+
+#if MULTIBUTTON_MAX_PORTS >= 4
+/* Test 32: Matrix keypad scanning with a simulated 8x8 matrix (no diodes) */
+static uint8_t sim_keys[8];     /* closed keys, bit c of row r */
+static uint8_t sim_row = 0;
+static int sim_drives = 0;
+
+static void sim_drive_row(uint8_t row)
+{
+    sim_row = row;
+    sim_drives++;
+}
+
+static uint8_t sim_read_cols(void)
+{
+    /* Current also flows through closed keys of rows sharing a column */
+    uint8_t cols = sim_keys[sim_row];
+    for (int r = 0; r < 8; r++) {
+        if (r != sim_row && (sim_keys[r] & cols)) cols |= sim_keys[r];
+    }
+    return cols;
+}
+
+static int test_matrix(void)
+{
+    ButtonMatrix matrix;
+    Button k00, k11, k57;
+
+    memset(sim_keys, 0, sizeof(sim_keys));
+    ASSERT(button_matrix_init(&matrix, 9, 8, sim_drive_row, sim_read_cols, 2) == -2);
+    ASSERT(button_matrix_init(&matrix, 8, 8, sim_drive_row, sim_read_cols, MULTIBUTTON_MAX_PORTS - 1) == -2);
+    ASSERT(button_matrix_init(&matrix, 8, 8, sim_drive_row, sim_read_cols, 2) == 0);
+    button_matrix_init_key(&k00, &matrix, 0, 0, 90);
+    button_matrix_init_key(&k11, &matrix, 1, 1, 91);
+    button_matrix_init_key(&k57, &matrix, 5, 7, 92);  /* second port word */
+    ASSERT(k57.port == 3);
+    button_start(&k00);
+    button_start(&k11);
+    button_start(&k57);
+
+    /* One scan per tick: rows driven once, however many keys are defined */
+    sim_drives = 0;
+    tick_n(10);
+    ASSERT(sim_drives == 8 * 10);
+
+    sim_keys[5] = 1U << 7;
+    tick_n(DEBOUNCE_TICKS + 1);
+    ASSERT(button_is_pressed(&k57) == 1);
+    ASSERT(button_is_pressed(&k00) == 0);
+    sim_keys[5] = 0;
+    tick_n(DEBOUNCE_TICKS + 1);
+    ASSERT(button_is_pressed(&k57) == 0);
+
+    /* Three corners of a rectangle: the ghost at (1,1) is rejected */
+    sim_keys[0] = (1U << 0) | (1U << 1);
+    sim_keys[1] = 1U << 0;
+    tick_n(DEBOUNCE_TICKS + 2);
+    ASSERT(matrix.ghosted == 1);
+    ASSERT(matrix.ghost_count > 0);
+    ASSERT(button_is_pressed(&k11) == 0);
+
+    /* Releasing one corner clears the ambiguity */
+    sim_keys[1] = 0;
+    tick_n(DEBOUNCE_TICKS + 1);
+    ASSERT(matrix.ghosted == 0);
+    ASSERT(button_is_pressed(&k00) == 1);
+    ASSERT(button_is_pressed(&k11) == 0);
+
+    memset(sim_keys, 0, sizeof(sim_keys));
+    tick_n(DEBOUNCE_TICKS + SHORT_TICKS + 5);
+    button_stop(&k00);
+    button_stop(&k11);
+    button_stop(&k57);
+    return 0;
+}
+#endif
+
+/* Test 33: Tick passes visit each started button once while callbacks relink the list */
+static Button relink_btn[3];
+static int relink_reads[3];
+static int relink_restarts = 0;
+static uint8_t relink_level = 0;
+
+static uint8_t relink_read(uint8_t button_id)
+{
+    relink_reads[button_id - 20]++;
+    return relink_level;
+}
+
+static void cb_restart_self(Button* btn, void* user_data)
+{
+    (void)user_data;
+    relink_restarts++;
+    button_stop(btn);
+    button_start(btn);  /* relinked at the head, ahead of buttons already visited */
+}
+
+static void cb_stop_last(Button* btn, void* user_data)
+{
+    (void)btn;
+    (void)user_data;
+    button_stop(&relink_btn[0]);  /* the button behind the caller */
+}
+
+static void cb_reinit_self(Button* btn, void* user_data)
+{
+    (void)user_data;
+    button_stop(btn);
+    button_init(btn, relink_read, 1, btn->button_id);  /* clears the next link */
+}
+
+static int test_list_relink(void)
+{
+    relink_level = 0;
+    relink_restarts = 0;
+    for (int i = 0; i < 3; i++) {
+        button_init(&relink_btn[i], relink_read, 1, (uint8_t)(20 + i));
+        button_start(&relink_btn[i]);  /* list order: 22, 21, 20 */
+    }
+    button_attach(&relink_btn[1], BTN_PRESS_DOWN, cb_restart_self, NULL);
+    button_attach(&relink_btn[2], BTN_PRESS_UP, cb_stop_last, NULL);
+
+    /* 21 moves to the head mid-pass: nobody is read twice or skipped */
+    relink_level = 1;
+    for (int t = 0; t < DEBOUNCE_TICKS + 3; t++) {
+        memset(relink_reads, 0, sizeof(relink_reads));
+        tick_n(1);
+        ASSERT(relink_reads[0] == 1 && relink_reads[1] == 1 && relink_reads[2] == 1);
+    }
+    ASSERT(relink_restarts == 1);
+
+    /* 22 stops 20 on release: 20 leaves the pass, the others stay */
+    relink_level = 0;
+    for (int t = 0; t < DEBOUNCE_TICKS + 3; t++) {
+        memset(relink_reads, 0, sizeof(relink_reads));
+        tick_n(1);
+        ASSERT(relink_reads[0] <= 1 && relink_reads[1] == 1 && relink_reads[2] == 1);
+    }
+    memset(relink_reads, 0, sizeof(relink_reads));
+    tick_n(3);
+    ASSERT(relink_reads[0] == 0 && relink_reads[1] == 3 && relink_reads[2] == 3);
+
+    button_stop(&relink_btn[1]);
+    button_stop(&relink_btn[2]);
+
+    /* 21 reinitializes itself on press: 20 behind it is still read in that pass */
+    for (int i = 0; i < 3; i++) {
+        button_init(&relink_btn[i], relink_read, 1, (uint8_t)(20 + i));
+        button_start(&relink_btn[i]);  /* list order: 22, 21, 20 */
+    }
+    button_attach(&relink_btn[1], BTN_PRESS_DOWN, cb_reinit_self, NULL);
+    relink_level = 1;
+    for (int t = 0; t < DEBOUNCE_TICKS + 3; t++) {
+        memset(relink_reads, 0, sizeof(relink_reads));
+        tick_n(1);
+        ASSERT(relink_reads[0] == 1 && relink_reads[1] <= 1 && relink_reads[2] == 1);
+    }
+    ASSERT(relink_btn[1].cb_mask == 0);  /* reinitialized once, then left stopped */
+
+    button_stop(&relink_btn[0]);
+    button_stop(&relink_btn[2]);
+    relink_level = 0;
+    return 0;
+}
+
+#if defined(MULTIBUTTON_GROUPS) && MULTIBUTTON_MAX_PORTS > 0
+/* Test 34: Groups keep separate lists, port words and tick rates */
+static uint32_t panel_port = 0;
+static uint32_t keypad_port = 0;
+static int group_events[2][BTN_EVENT_COUNT];
+
+static uint32_t panel_read(uint8_t port)  { (void)port; return panel_port; }
+static uint32_t keypad_read(uint8_t port) { (void)port; return keypad_port; }
+
+static void log_group_event(Button* btn, void* user_data)
+{
+    (void)user_data;
+    group_events[btn->button_id - 40][button_get_dispatched_event(btn)]++;
+}
+
+static int group_reads[3];
+static uint8_t group_level = 0;
+static ButtonGroup* move_from;
+static ButtonGroup* move_to;
+
+static uint8_t group_read(uint8_t button_id)
+{
+    group_reads[button_id - 43]++;
+    return group_level;
+}
+
+static void cb_move_group(Button* btn, void* user_data)
+{
+    (void)user_data;
+    button_group_stop(move_from, btn);
+    button_group_start(move_to, btn);  /* linked ahead of the other group's buttons */
+}
+
+static void group_tick(ButtonGroup* group, int n)
+{
+    for (int i = 0; i < n; i++) {
+        button_group_ticks(group);
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+        button_group_dispatch_pending(group);
+#endif
+    }
+}
+
+static int test_groups(void)
+{
+    static ButtonGroup panel, keypad;
+    Button a, b;
+
+    memset(group_events, 0, sizeof(group_events));
+    panel_port = keypad_port = 0;
+    button_group_init(&panel);
+    button_group_init(&keypad);
+    button_group_port_init(&panel, panel_read);
+    button_group_port_init(&keypad, keypad_read);
+
+    /* Same port index and pin in both groups, each group debounces its own word */
+    button_init_port(&a, 0, 1U << 3, 1, 40);
+    button_init_port(&b, 0, 1U << 3, 1, 41);
+    for (int ev = 0; ev < BTN_EVENT_COUNT; ev++) {
+        button_attach(&a, (ButtonEvent)ev, log_group_event, NULL);
+        button_attach(&b, (ButtonEvent)ev, log_group_event, NULL);
+    }
+    ASSERT(button_group_start(&panel, &a) == 0);
+    ASSERT(button_group_start(&keypad, &b) == 0);
+    ASSERT(button_group_start(&keypad, &a) == -1);  /* already started in another group */
+    ASSERT(button_group_all_idle(&panel) == 1);
+
+    /* Ticking one group leaves the other and the default group alone */
+    panel_port = 1U << 3;
+    keypad_port = 1U << 3;
+    group_tick(&panel, DEBOUNCE_TICKS + 1);
+    ASSERT(button_is_pressed(&a) == 1);
+    ASSERT(button_is_pressed(&b) == 0);
+    ASSERT(group_events[0][BTN_PRESS_DOWN] == 1);
+    ASSERT(group_events[1][BTN_PRESS_DOWN] == 0);
+    ASSERT(button_group_all_idle(&panel) == 0);
+    ASSERT(button_group_all_idle(&keypad) == 1);
+    tick_n(LONG_TICKS + 5);
+    ASSERT(group_events[0][BTN_LONG_PRESS_START] == 0);
+    ASSERT(group_events[1][BTN_PRESS_DOWN] == 0);
+
+    /* Keypad ticked at a quarter of the panel rate: long press takes four times as many panel ticks */
+    panel_port = keypad_port = 0;
+    group_tick(&panel, DEBOUNCE_TICKS + SHORT_TICKS + 5);
+    memset(group_events, 0, sizeof(group_events));
+    panel_port = keypad_port = 1U << 3;
+    for (int t = 0; t < 4 * (DEBOUNCE_TICKS + LONG_TICKS + 2); t++) {
+        group_tick(&panel, 1);
+        if (t % 4 == 3) {
+            group_tick(&keypad, 1);
+        }
+        if (t == DEBOUNCE_TICKS + LONG_TICKS + 2) {
+            ASSERT(group_events[0][BTN_LONG_PRESS_START] == 1);
+            ASSERT(group_events[1][BTN_LONG_PRESS_START] == 0);
+        }
+    }
+    ASSERT(group_events[1][BTN_PRESS_DOWN] == 1);
+    ASSERT(group_events[1][BTN_LONG_PRESS_START] == 1);
+
+    /* Stopping through the wrong group is ignored */
+    button_group_stop(&keypad, &a);
+    ASSERT(button_group_start(&panel, &a) == -1);  /* still started */
+    button_group_stop(&panel, &a);
+    button_group_stop(&keypad, &b);
+    ASSERT(button_group_start(&keypad, &a) == 0 && button_group_start(&panel, &b) == 0);
+    button_group_stop(&keypad, &a);
+    button_group_stop(&panel, &b);
+
+    /* A callback moves a panel button to the keypad: the panel pass still
+       visits its own remaining button and none of the keypad's */
+    Button m, n, k;
+    memset(group_reads, 0, sizeof(group_reads));
+    group_level = 0;
+    move_from = &panel;
+    move_to = &keypad;
+    button_init(&m, group_read, 1, 43);
+    button_init(&n, group_read, 1, 44);
+    button_init(&k, group_read, 1, 45);
+    button_attach(&m, BTN_PRESS_DOWN, cb_move_group, NULL);
+    button_group_start(&panel, &n);
+    button_group_start(&panel, &m);  /* panel list: m, n */
+    button_group_start(&keypad, &k);
+    group_level = 1;
+    for (int t = 0; t < DEBOUNCE_TICKS + 3; t++) {
+        memset(group_reads, 0, sizeof(group_reads));
+        group_tick(&panel, 1);
+        ASSERT(group_reads[1] == 1 && group_reads[2] == 0);
+    }
+    ASSERT(m.group == &keypad && button_is_pressed(&n) == 1);
+    button_group_stop(&keypad, &m);
+    button_group_stop(&panel, &n);
+    button_group_stop(&keypad, &k);
+    return 0;
+}
+#endif
+
+#if defined(MULTIBUTTON_GROUPS) && defined(MULTIBUTTON_TIME_DRIVEN)
+/* Test 35: Adaptive ticking slows down while idle and keeps press timing */
+static uint8_t adaptive_level = 0;
+static uint32_t adaptive_now = 0;
+static int adaptive_events[BTN_EVENT_COUNT];
+static uint32_t adaptive_ms[BTN_EVENT_COUNT];
+
+static uint8_t adaptive_read(uint8_t button_id)
+{
+    (void)button_id;
+    return adaptive_level;
+}
+
+static void log_adaptive(Button* btn, void* user_data)
+{
+    (void)user_data;
+    ButtonEvent ev = button_get_dispatched_event(btn);
+    if (adaptive_events[ev]++ == 0) {
+        adaptive_ms[ev] = adaptive_now;  /* time of the first occurrence */
+    }
+}
+
+/* Run for 'duration' ms, each call after the interval recommended by the previous one */
+static int adaptive_run(ButtonGroup* group, uint16_t* interval, uint32_t duration)
+{
+    uint32_t end = adaptive_now + duration;
+    int calls = 0;
+
+    while (adaptive_now < end) {
+        adaptive_now += *interval;
+        *interval = button_group_ticks_elapsed(group, *interval);
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+        button_group_dispatch_pending(group);
+#endif
+        calls++;
+    }
+    return calls;
+}
+
+static int test_adaptive_tick(void)
+{
+    static ButtonGroup group;
+    Button btn;
+    uint16_t interval = TICKS_INTERVAL;
+
+    memset(adaptive_events, 0, sizeof(adaptive_events));
+    adaptive_level = 0;
+    adaptive_now = 0;
+    button_group_init(&group);
+    button_init(&btn, adaptive_read, 1, 50);
+    for (int ev = 0; ev < BTN_EVENT_COUNT; ev++) {
+        button_attach(&btn, (ButtonEvent)ev, log_adaptive, NULL);
+    }
+    button_group_start(&group, &btn);
+
+    /* Idle: one call per idle period */
+    int calls = adaptive_run(&group, &interval, 1000);
+    ASSERT(interval == MULTIBUTTON_IDLE_INTERVAL);
+    ASSERT(calls <= 1000 / MULTIBUTTON_IDLE_INTERVAL + 1);
+
+    /* Press: seen by the next call, then sampled every tick with long press timing kept */
+    uint32_t press_ms = adaptive_now;
+    adaptive_level = 1;
+    adaptive_run(&group, &interval, 1500);
+    ASSERT(interval == TICKS_INTERVAL);
+    ASSERT(adaptive_events[BTN_PRESS_DOWN] == 1);
+    ASSERT(adaptive_ms[BTN_PRESS_DOWN] - press_ms <= MULTIBUTTON_IDLE_INTERVAL + DEBOUNCE_MS + TICKS_INTERVAL);
+    ASSERT(adaptive_events[BTN_LONG_PRESS_START] == 1);
+    uint32_t held = adaptive_ms[BTN_LONG_PRESS_START] - adaptive_ms[BTN_PRESS_DOWN];
+    ASSERT(held >= LONG_TICKS * TICKS_INTERVAL && held <= (LONG_TICKS + 2) * TICKS_INTERVAL);
+
+    /* Release: back to the idle period */
+    adaptive_level = 0;
+    adaptive_run(&group, &interval, 500);
+    ASSERT(adaptive_events[BTN_PRESS_UP] == 1);
+    ASSERT(interval == MULTIBUTTON_IDLE_INTERVAL);
+    ASSERT(button_group_all_idle(&group) == 1);
+
+    button_group_stop(&group, &btn);
+    return 0;
+}
+#endif
+
+#if defined(MULTIBUTTON_TYPEMATIC) && defined(MULTIBUTTON_PROFILES)
+/* Test 36: Typematic hold repeats with delay, interval and acceleration */
+static const ButtonProfile typematic_profile = { SHORT_TICKS, LONG_TICKS, DEBOUNCE_TICKS, 2, 40, 20, 5 };
+static const ButtonProfile typematic_fast_profile = { SHORT_TICKS, LONG_TICKS, DEBOUNCE_TICKS, 8, 64, 64, 4 };
+static int typematic_tick = 0;
+static int typematic_holds[48];
+static int typematic_count = 0;
+static int typematic_start = 0;
+static int typematic_repeat_bad = 0;
+
+static void log_typematic_start(Button* btn, void* user_data)
+{
+    (void)user_data;
+    typematic_start = typematic_tick;
+    if (button_get_repeat_count(btn) != 1) typematic_repeat_bad++;
+}
+
+static void log_typematic_hold(Button* btn, void* user_data)
+{
+    (void)user_data;
+    if (typematic_count < 48) typematic_holds[typematic_count] = typematic_tick;
+    typematic_count++;
+    if (button_get_repeat_count(btn) != 1) typematic_repeat_bad++;
+}
+
+static int test_typematic(void)
+{
+    /* Gaps: delay, two repeats per step halving the interval, then the floor */
+    static const int gaps[] = { 40, 20, 20, 10, 10, 5, 5, 5, 5 };
+    const int n = (int)(sizeof(gaps) / sizeof(gaps[0]));
+    Button btn;
+
+    mock_gpio_value = 0;
+    typematic_count = 0;
+    typematic_start = 0;
+    typematic_repeat_bad = 0;
+    button_init(&btn, mock_read_gpio, 1, 60);
+    button_set_profile(&btn, &typematic_profile);
+    button_attach(&btn, BTN_LONG_PRESS_START, log_typematic_start, NULL);
+    button_attach(&btn, BTN_LONG_PRESS_HOLD, log_typematic_hold, NULL);
+    button_start(&btn);
+
+    mock_gpio_value = 1;
+    int end = DEBOUNCE_TICKS + LONG_TICKS + 2 + 40 + 2 * 20 + 2 * 10 + 4 * 5;
+    for (typematic_tick = 1; typematic_tick <= end; typematic_tick++) {
+        tick_n(1);
+    }
+    ASSERT(typematic_start == DEBOUNCE_TICKS + LONG_TICKS + 1);
+    ASSERT(typematic_count == n);
+    for (int i = 0, last = typematic_start; i < n; i++) {
+        ASSERT(typematic_holds[i] - last == gaps[i]);
+        last = typematic_holds[i];
+    }
+
+    /* Tickless: the next repeat is the next deadline */
+    ASSERT(button_next_deadline() == 5 - (end - typematic_holds[n - 1]));
+
+    /* Release ends the repeats */
+    mock_gpio_value = 0;
+    tick_n(DEBOUNCE_TICKS + 40);
+    ASSERT(typematic_count == n);
+    ASSERT(btn.state == BTN_STATE_IDLE);
+
+    /* Acceleration past 15 repeats: 8 repeats per step, 64 halves down to 4 */
+    button_set_profile(&btn, &typematic_fast_profile);
+    typematic_count = 0;
+    mock_gpio_value = 1;
+    end = DEBOUNCE_TICKS + LONG_TICKS + 2 + 64 + 8 * (64 + 32 + 16 + 8) + 8 * 4;
+    for (typematic_tick = 1; typematic_tick <= end; typematic_tick++) {
+        tick_n(1);
+    }
+    ASSERT(typematic_count == 1 + 8 * 4 + 8);
+    for (int i = 1, last = typematic_holds[0]; i < typematic_count; i++) {
+        int step = (i - 1) / 8;
+        ASSERT(typematic_holds[i] - last == (step < 4 ? 64 >> step : 4));
+        last = typematic_holds[i];
+    }
+
+    /* The repeat count keeps the press count during the hold */
+    ASSERT(typematic_repeat_bad == 0);
+    ASSERT(button_get_repeat_count(&btn) == 1);
+
+    mock_gpio_value = 0;
+    tick_n(DEBOUNCE_TICKS + 40);
+    button_stop(&btn);
+    return 0;
+}
+#endif
+
+/* Test 37: Subscription mask follows attach/detach, unsubscribed events still polled */
+static ButtonEvent mask_seen = BTN_NONE_PRESS;
+static ButtonEvent mask_live = BTN_NONE_PRESS;
+static int mask_calls = 0;
+
+static void log_mask_event(Button* btn, void* user_data)
+{
+    (void)user_data;
+    mask_seen = button_get_dispatched_event(btn);
+    mask_live = button_get_event(btn);
+    mask_calls++;
+}
+
+static int test_subscription_mask(void)
+{
+    Button btn;
+
+    mock_gpio_value = 0;
+    button_init(&btn, mock_read_gpio, 1, 61);
+    ASSERT(btn.cb_mask == 0);
+    button_attach(&btn, BTN_PRESS_DOWN, log_mask_event, NULL);
+    button_attach(&btn, BTN_SINGLE_CLICK, log_mask_event, NULL);
+    ASSERT(btn.cb_mask == ((1U << BTN_PRESS_DOWN) | (1U << BTN_SINGLE_CLICK)));
+    button_detach(&btn, BTN_SINGLE_CLICK);
+    button_attach(&btn, BTN_PRESS_UP, NULL, NULL);  /* NULL callback does not subscribe */
+    ASSERT(btn.cb_mask == (1U << BTN_PRESS_DOWN));
+    button_start(&btn);
+
+    /* Second press emits PRESS_DOWN and PRESS_REPEAT: only PRESS_DOWN is delivered */
+    mask_calls = 0;
+    mock_gpio_value = 1;
+    tick_n(DEBOUNCE_TICKS + 2);
+    mock_gpio_value = 0;
+    tick_n(DEBOUNCE_TICKS + 2);
+    ASSERT(button_get_event(&btn) == BTN_PRESS_UP);  /* polled without a callback */
+    mock_gpio_value = 1;
+    tick_n(DEBOUNCE_TICKS + 1);
+    ASSERT(mask_calls == 2);
+    ASSERT(mask_seen == BTN_PRESS_DOWN);
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+    ASSERT(mask_live == BTN_PRESS_REPEAT);  /* the live event is not overridden */
+#else
+    ASSERT(mask_live == BTN_PRESS_DOWN);
+#endif
+    ASSERT(button_get_event(&btn) == BTN_PRESS_REPEAT);
+
+    /* Nothing subscribed: the state machine still runs for polling */
+    button_detach(&btn, BTN_PRESS_DOWN);
+    ASSERT(btn.cb_mask == 0);
+    mock_gpio_value = 0;
+    tick_n(DEBOUNCE_TICKS + SHORT_TICKS + 5);
+    ASSERT(mask_calls == 2);
+    ASSERT(btn.state == BTN_STATE_IDLE);
+
+    button_stop(&btn);
+    return 0;
+}
+
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+/* Test 38: Deferred dispatch runs callbacks from the main loop, counts overflows */
+static int test_deferred_queue(void)
+{
+    Button many[MULTIBUTTON_EVENT_QUEUE_SIZE + 2];
+    int n = MULTIBUTTON_EVENT_QUEUE_SIZE + 2;
+    uint32_t overflows = button_queue_overflows();
+
+    mock_gpio_value = 0;
+    reset_event_log();
+    for (int i = 0; i < n; i++) {
+        button_init(&many[i], mock_read_gpio, 1, (uint8_t)(50 + i));
+        button_attach(&many[i], BTN_PRESS_DOWN, log_press_down, NULL);
+        button_start(&many[i]);
+    }
+
+    /* All buttons press in the same tick: callbacks are only queued */
+    mock_gpio_value = 1;
+    for (int i = 0; i < DEBOUNCE_TICKS + 1; i++) button_ticks();
+    ASSERT(event_count == 0);
+    ASSERT(button_queue_overflows() - overflows == 2);
+
+    ASSERT(button_dispatch_pending() == MULTIBUTTON_EVENT_QUEUE_SIZE);
+    ASSERT(count_event(BTN_PRESS_DOWN) == MULTIBUTTON_EVENT_QUEUE_SIZE);
+    ASSERT(button_dispatch_pending() == 0);
+
+    for (int i = 0; i < n; i++) {
+        button_stop(&many[i]);
+    }
+    mock_gpio_value = 0;
+    return 0;
+}
+#endif
+
+#if MULTIBUTTON_BATCH_SIZE > 0
+/* Test 39: Batch sink receives all events of a tick in one call */
+static int batch_calls = 0;
+static int batch_records = 0;
+static int batch_max = 0;
+
+static void batch_sink(const ButtonEventRecord* records, uint16_t count, void* user_data)
+{
+    (void)user_data;
+    batch_calls++;
+    batch_records += count;
+    if (count > batch_max) batch_max = count;
+    for (uint16_t i = 0; i < count; i++) {
+        if (records[i].event == BTN_PRESS_DOWN && records[i].repeat != 1) batch_records = -1000;
+    }
+}
+
+static int test_batch_sink(void)
+{
+    Button many[MULTIBUTTON_BATCH_SIZE + 2];
+    int n = MULTIBUTTON_BATCH_SIZE + 2;
+
+    mock_gpio_value = 0;
+    for (int i = 0; i < n; i++) {
+        button_init(&many[i], mock_read_gpio, 1, (uint8_t)(60 + i));
+        button_start(&many[i]);
+    }
+    button_set_batch_sink(batch_sink, NULL);
+    batch_calls = batch_records = batch_max = 0;
+
+    /* Idle ticks deliver nothing */
+    tick_n(3);
+    ASSERT(batch_calls == 0);
+
+    /* All buttons press in the same tick: one full batch plus the rest */
+    mock_gpio_value = 1;
+    tick_n(DEBOUNCE_TICKS);
+    ASSERT(batch_records == n);
+    ASSERT(batch_calls == 2);
+    ASSERT(batch_max == MULTIBUTTON_BATCH_SIZE);
+
+    button_set_batch_sink(NULL, NULL);
+    for (int i = 0; i < n; i++) {
+        button_stop(&many[i]);
+    }
+    mock_gpio_value = 0;
+    return 0;
+}
+#endif
+
+#ifdef MULTIBUTTON_STATS
+/* Test 40: Instrumentation counters and tick duration histogram */
+static uint32_t fake_cycles = 0;
+
+uint32_t button_cycles(void)
+{
+    return fake_cycles;
+}
+
+#if MULTIBUTTON_MAX_PORTS > 0
+
+static void cb_slow(Button* btn, void* user_data)
+{
+    (void)btn;
+    (void)user_data;
+    fake_cycles += 500;  /* callback "runs" for 500 cycles */
+}
+
+static int test_stats(void)
+{
+    Button pin, port_btn;
+    const ButtonStats* st;
+    const ButtonTickStats* ts;
+
+    mock_gpio_value = 0;
+    mock_port_value = 0;
+    button_port_init(mock_read_port);
+    button_init(&pin, mock_read_gpio, 1, 70);
+    button_attach(&pin, BTN_PRESS_DOWN, cb_slow, NULL);
+    button_init_port(&port_btn, 0, 1UL << 3, 1, 71);
+    button_start(&pin);
+    button_start(&port_btn);
+    button_tick_stats_reset();
+    ASSERT(button_get_stats(NULL) == NULL);
+
+    /* One-tick glitches are rejected and counted on both input paths */
+    mock_gpio_value = 1;
+    mock_port_value = 1UL << 3;
+    tick_n(1);
+    mock_gpio_value = 0;
+    mock_port_value = 0;
+    tick_n(5);
+    ASSERT(button_get_stats(&pin)->bounces == 1);
+    ASSERT(button_get_stats(&port_btn)->bounces == 1);
+
+    ts = button_get_tick_stats();
+    ASSERT(ts->count == 6);
+    ASSERT(ts->hist[0] == 6);  /* no time spent without callbacks */
+
+    /* Click: the tick running the slow callback lands in the 256 ~ 511 bucket */
+    mock_gpio_value = 1;
+    tick_n(DEBOUNCE_TICKS + 2);
+    mock_gpio_value = 0;
+    tick_n(DEBOUNCE_TICKS + SHORT_TICKS + 2);
+    st = button_get_stats(&pin);
+    ASSERT(st->events[BTN_PRESS_DOWN] == 1);
+    ASSERT(st->events[BTN_PRESS_UP] == 1);
+    ASSERT(st->events[BTN_SINGLE_CLICK] == 1);
+    ASSERT(st->max_cb_cycles == 500);
+    ASSERT(ts->hist[9] == 1);
+    ASSERT(ts->max_cycles == 500);
+    ASSERT(button_get_stats(&port_btn)->events[BTN_PRESS_DOWN] == 0);
+
+    button_stats_reset(&pin);
+    ASSERT(button_get_stats(&pin)->events[BTN_SINGLE_CLICK] == 0);
+    button_tick_stats_reset();
+    ASSERT(ts->count == 0);
+
+    button_stop(&pin);
+    button_stop(&port_btn);
+    return 0;
+}
+#endif
+#endif
+
+#if MULTIBUTTON_TRACE_SIZE > 0
+/* Test 41: Trace recorder keeps the newest transitions in packed records */
+static int test_trace(void)
+{
+    Button btn;
+    uint32_t recs[MULTIBUTTON_TRACE_SIZE];
+    uint32_t mine[MULTIBUTTON_TRACE_SIZE];
+    uint16_t n, count = 0;
+
+    mock_gpio_value = 0;
+    button_init(&btn, mock_read_gpio, 1, 80);
+    button_start(&btn);
+    button_trace_clear();
+    ASSERT(button_trace_dump(recs, MULTIBUTTON_TRACE_SIZE) == 0);
+
+    /* Single click: press, release, click timeout */
+    mock_gpio_value = 1;
+    tick_n(DEBOUNCE_TICKS + 2);
+    mock_gpio_value = 0;
+    tick_n(DEBOUNCE_TICKS + SHORT_TICKS + 2);
+
+    n = button_trace_dump(recs, MULTIBUTTON_TRACE_SIZE);
+    for (uint16_t i = 0; i < n; i++) {
+        if (BUTTON_TRACE_ID(recs[i]) == 80) mine[count++] = recs[i];
+    }
+    ASSERT(count == 3);
+    ASSERT(BUTTON_TRACE_OLD_STATE(mine[0]) == BTN_STATE_IDLE);
+    ASSERT(BUTTON_TRACE_NEW_STATE(mine[0]) == BTN_STATE_PRESS);
+    ASSERT(BUTTON_TRACE_EVENT(mine[0]) == BTN_PRESS_DOWN);
+    ASSERT(BUTTON_TRACE_EVENT(mine[1]) == BTN_PRESS_UP);
+    ASSERT(BUTTON_TRACE_NEW_STATE(mine[2]) == BTN_STATE_IDLE);
+    ASSERT(BUTTON_TRACE_EVENT(mine[2]) == BTN_SINGLE_CLICK);
+    ASSERT((uint16_t)(BUTTON_TRACE_TICK(mine[2]) - BUTTON_TRACE_TICK(mine[0])) > SHORT_TICKS);
+
+    /* Overflow keeps the newest records */
+    for (int i = 0; i < MULTIBUTTON_TRACE_SIZE; i++) {
+        mock_gpio_value = 1;
+        tick_n(DEBOUNCE_TICKS + 2);
+        mock_gpio_value = 0;
+        tick_n(DEBOUNCE_TICKS + SHORT_TICKS + 2);
+    }
+    ASSERT(button_trace_dump(recs, MULTIBUTTON_TRACE_SIZE) == MULTIBUTTON_TRACE_SIZE);
+    ASSERT(BUTTON_TRACE_EVENT(recs[MULTIBUTTON_TRACE_SIZE - 1]) == BTN_SINGLE_CLICK);
+    ASSERT(button_trace_dump(recs, 2) == 2);
+    ASSERT(BUTTON_TRACE_EVENT(recs[1]) == BTN_SINGLE_CLICK);
+
+    button_stop(&btn);
+    return 0;
+}
+#endif
+
 /* ============================================================ */
 
 int main(void)
@@ -511,6 +2201,57 @@ int main(void)
     RUN_TEST(test_user_data);
     RUN_TEST(test_debounce_boundary);
     RUN_TEST(test_rapid_press_release);
+#if MULTIBUTTON_MAX_PORTS > 0
+    RUN_TEST(test_port_mapped);
+    RUN_TEST(test_slice_debounce_equivalence);
+#endif
+    RUN_TEST(test_pool_equivalence);
+    RUN_TEST(test_start_stop_order);
+    RUN_TEST(test_next_deadline);
+#ifdef MULTIBUTTON_TIME_DRIVEN
+    RUN_TEST(test_edge_equivalence);
+    RUN_TEST(test_edge_click);
+    RUN_TEST(test_ticks_at_equivalence);
+    RUN_TEST(test_ticks_at_jitter);
+    RUN_TEST(test_ticks_at_glitch);
+    RUN_TEST(test_ticks_at_long_idle);
+#endif
+    RUN_TEST(test_shared_config);
+#ifdef MULTIBUTTON_PROFILES
+    RUN_TEST(test_profiles);
+#endif
+#ifdef MULTIBUTTON_GESTURES
+    RUN_TEST(test_gestures);
+#endif
+#ifdef MULTIBUTTON_CHORDS
+    RUN_TEST(test_chords);
+#endif
+#if MULTIBUTTON_MAX_PORTS >= 4
+    RUN_TEST(test_matrix);
+#endif
+    RUN_TEST(test_list_relink);
+#if defined(MULTIBUTTON_GROUPS) && MULTIBUTTON_MAX_PORTS > 0
+    RUN_TEST(test_groups);
+#endif
+#if defined(MULTIBUTTON_GROUPS) && defined(MULTIBUTTON_TIME_DRIVEN)
+    RUN_TEST(test_adaptive_tick);
+#endif
+#if defined(MULTIBUTTON_TYPEMATIC) && defined(MULTIBUTTON_PROFILES)
+    RUN_TEST(test_typematic);
+#endif
+    RUN_TEST(test_subscription_mask);
+#if MULTIBUTTON_EVENT_QUEUE_SIZE > 0
+    RUN_TEST(test_deferred_queue);
+#endif
+#if MULTIBUTTON_BATCH_SIZE > 0
+    RUN_TEST(test_batch_sink);
+#endif
+#if defined(MULTIBUTTON_STATS) && MULTIBUTTON_MAX_PORTS > 0
+    RUN_TEST(test_stats);
+#endif
+#if MULTIBUTTON_TRACE_SIZE > 0
+    RUN_TEST(test_trace);
+#endif
 
     printf("\nResults: %d/%d passed", tests_passed, tests_run);
     if (tests_failed > 0) {
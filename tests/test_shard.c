@@ -0,0 +1,172 @@
+/*
+ * MultiButton Sharded Ticking Tests
+ * Minimal test framework with no external dependencies.
+ * Compares sharded multi-threaded ticking against a single pool ticked
+ * on the calling thread.
+ */
+
+#include "multi_button_shard.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ---- Minimal test framework ---- */
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define ASSERT(expr) do { \
+    if (!(expr)) { \
+        printf("  FAIL: %s (line %d)\n", #expr, __LINE__); \
+        return 1; \
+    } \
+} while(0)
+
+#define RUN_TEST(fn) do { \
+    tests_run++; \
+    printf("  [%d] %s ... ", tests_run, #fn); \
+    if (fn() == 0) { tests_passed++; printf("OK\n"); } \
+    else { tests_failed++; printf("FAILED\n"); } \
+} while(0)
+
+#define NUM_SHARDS      4
+#define SHARD_SLOTS     300
+#define NUM_TICKS       3000
+#define MAX_RECORDS     200000
+
+/* ---- Simulated inputs: each button toggles with its own period ---- */
+static int sim_tick = 0;
+
+static uint8_t sim_level(uint32_t global)
+{
+    uint32_t period = 3 + (global * 2654435761U >> 24) % 120;
+    return (uint8_t)(((uint32_t)sim_tick + global) / period & 1U);
+}
+
+static uint8_t read_sharded(uint16_t index)
+{
+    return sim_level((uint32_t)button_shard_current() * SHARD_SLOTS + index);
+}
+
+static uint8_t read_single(uint16_t index)
+{
+    return sim_level(index);
+}
+
+/* ---- Event streams ---- */
+static ButtonShardEvent sharded_log[MAX_RECORDS];
+static ButtonShardEvent single_log[MAX_RECORDS];
+static uint32_t sharded_count = 0;
+static uint32_t single_count = 0;
+static uint16_t last_shard = 0;
+static int out_of_order = 0;
+
+static void shard_sink(const ButtonShardEvent* events, uint32_t count, void* user_data)
+{
+    (void)user_data;
+    if (events[0].shard < last_shard) out_of_order = 1;
+    last_shard = events[0].shard;
+    for (uint32_t i = 0; i < count && sharded_count < MAX_RECORDS; i++) {
+        sharded_log[sharded_count++] = events[i];
+    }
+}
+
+static void single_event(ButtonPool* pool, uint16_t index, void* user_data)
+{
+    (void)user_data;
+    if (single_count < MAX_RECORDS) {
+        ButtonShardEvent* ev = &single_log[single_count++];
+        ev->shard = (uint16_t)(index / SHARD_SLOTS);
+        ev->index = (uint16_t)(index % SHARD_SLOTS);
+        ev->event = (uint8_t)button_pool_get_event(pool, index);
+        ev->repeat = button_pool_get_repeat_count(pool, index);
+    }
+}
+
+/* Test 1: Sharded event stream equals the single-threaded stream */
+static int test_shard_equivalence(void)
+{
+    ButtonPool pools[NUM_SHARDS];
+    ButtonShard shards[NUM_SHARDS];
+    ButtonShards group;
+    ButtonPool single;
+
+    memset(shards, 0, sizeof(shards));
+    for (int s = 0; s < NUM_SHARDS; s++) {
+        ASSERT(button_shard_pool_create(&pools[s], SHARD_SLOTS) == 0);
+        button_pool_init(&pools[s], read_sharded);
+        for (int i = 0; i < SHARD_SLOTS; i++) {
+            button_pool_add(&pools[s], 1);
+        }
+        shards[s].pool = &pools[s];
+    }
+    ASSERT(button_shards_init(&group, shards, NUM_SHARDS, shard_sink, NULL) == 0);
+
+    ASSERT(button_shard_pool_create(&single, NUM_SHARDS * SHARD_SLOTS) == 0);
+    button_pool_init(&single, read_single);
+    for (int i = 0; i < NUM_SHARDS * SHARD_SLOTS; i++) {
+        button_pool_add(&single, 1);
+        for (int ev = 0; ev < BTN_EVENT_COUNT; ev++) {
+            button_pool_attach(&single, (uint16_t)i, (ButtonEvent)ev, single_event, NULL);
+        }
+    }
+
+    ASSERT(button_shard_current() == -1);
+    for (sim_tick = 0; sim_tick < NUM_TICKS; sim_tick++) {
+        last_shard = 0;
+        button_shards_tick(&group);
+        button_pool_ticks(&single);
+    }
+
+    ASSERT(!out_of_order);
+    ASSERT(sharded_count > 1000);
+    ASSERT(sharded_count == single_count);
+    ASSERT(memcmp(sharded_log, single_log, sharded_count * sizeof(ButtonShardEvent)) == 0);
+    for (int s = 0; s < NUM_SHARDS; s++) {
+        ASSERT(shards[s].dropped == 0);
+    }
+
+    button_shards_destroy(&group);
+    for (int s = 0; s < NUM_SHARDS; s++) {
+        for (int ev = 0; ev < BTN_EVENT_COUNT; ev++) {
+            ASSERT(pools[s].cold[0].cb[ev] == NULL);  /* no callback into freed buffers */
+        }
+        button_shard_pool_destroy(&pools[s]);
+    }
+    button_shard_pool_destroy(&single);
+    return 0;
+}
+
+/* Test 2: Invalid parameters */
+static int test_shard_invalid(void)
+{
+    ButtonShard shard;
+    ButtonShards group;
+
+    memset(&shard, 0, sizeof(shard));
+    ASSERT(button_shards_init(NULL, &shard, 1, NULL, NULL) == -2);
+    ASSERT(button_shards_init(&group, &shard, 0, NULL, NULL) == -2);
+    ASSERT(button_shards_init(&group, &shard, 1, NULL, NULL) == -2);  /* no pool */
+    ASSERT(button_shard_pool_create(NULL, 8) == -2);
+    button_shards_tick(NULL);
+    button_shards_destroy(NULL);
+    return 0;
+}
+
+int main(void)
+{
+    printf("MultiButton Shard Tests (v%d.%d.%d)\n",
+           MULTIBUTTON_VERSION_MAJOR, MULTIBUTTON_VERSION_MINOR, MULTIBUTTON_VERSION_PATCH);
+    printf("=====================================\n");
+
+    RUN_TEST(test_shard_equivalence);
+    RUN_TEST(test_shard_invalid);
+
+    printf("\nResults: %d/%d passed", tests_passed, tests_run);
+    if (tests_failed > 0) {
+        printf(", %d FAILED", tests_failed);
+    }
+    printf("\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * MultiButton Input Replay
+ * Memory-maps a recorded input file and feeds it through button_ticks() as
+ * fast as possible, writing the resulting event stream to a text file.
+ * Used for golden-output regression tests and as a throughput benchmark on
+ * captured bounce data.
+ * Usage: replay input.rec [events.txt]   (without events.txt only counts events)
+ *
+ * Input file (little-endian):
+ *   offset  0  char[4]   magic "MBRP"
+ *   offset  4  uint16    version (1)
+ *   offset  6  uint16    buttons (1 ~ 32 * MULTIBUTTON_MAX_PORTS, at most 256)
+ *   offset  8  uint32    ticks
+ *   offset 12  uint16    flags, bit 0: inputs are active low
+ *   offset 14  uint16    reserved (0)
+ *   offset 16  uint32    frames[ticks][(buttons + 31) / 32]: raw level of button n in bit n % 32
+ *                        of word n / 32, one frame per TICKS_INTERVAL
+ *
+ * Output: one line per event, "tick button_id EVENT repeat".
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "multi_button.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define REPLAY_HEADER_SIZE   16
+#define REPLAY_MAX_BUTTONS   ((32 * MULTIBUTTON_MAX_PORTS < 256) ? 32 * MULTIBUTTON_MAX_PORTS : 256)
+
+static const char* const event_names[BTN_EVENT_COUNT] = {
+    "PRESS_DOWN", "PRESS_UP", "PRESS_REPEAT", "SINGLE_CLICK",
+    "DOUBLE_CLICK", "LONG_PRESS_START", "LONG_PRESS_HOLD"
+};
+
+static Button buttons[REPLAY_MAX_BUTTONS];
+static const uint8_t* frame;        // frame of the current tick
+static uint32_t tick = 0;
+static unsigned long events = 0;
+static FILE* out = NULL;
+
+static uint32_t le32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint16_t le16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+// Port words come straight from the mapped file
+static uint32_t read_port(uint8_t port)
+{
+    return le32(frame + 4U * port);
+}
+
+static void on_event(Button* btn, void* user_data)
+{
+    (void)user_data;
+    events++;
+    if (out) {
+        fprintf(out, "%u %u %s %u\n", tick, btn->button_id, event_names[button_get_event(btn)],
+                button_get_repeat_count(btn));
+    }
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: replay input.rec [events.txt]\n");
+        return 2;
+    }
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size < REPLAY_HEADER_SIZE) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+    const uint8_t* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "cannot map %s\n", argv[1]);
+        return 1;
+    }
+
+    uint16_t count = le16(map + 6);
+    uint32_t ticks = le32(map + 8);
+    uint8_t active_level = (le16(map + 12) & 1U) ? 0 : 1;
+    uint32_t words = (count + 31U) / 32U;
+    if (map[0] != 'M' || map[1] != 'B' || map[2] != 'R' || map[3] != 'P' || le16(map + 4) != 1 ||
+        !count || count > REPLAY_MAX_BUTTONS ||
+        (uint64_t)st.st_size < REPLAY_HEADER_SIZE + (uint64_t)ticks * words * 4U) {
+        fprintf(stderr, "%s: not a version 1 recording for up to %d buttons\n", argv[1], REPLAY_MAX_BUTTONS);
+        return 1;
+    }
+
+    if (argc > 2) {
+        out = fopen(argv[2], "w");
+        if (!out) {
+            fprintf(stderr, "cannot open %s\n", argv[2]);
+            return 1;
+        }
+        setvbuf(out, NULL, _IOFBF, 1 << 16);
+    }
+
+    button_port_init(read_port);
+    for (uint16_t i = 0; i < count; i++) {
+        button_init_port(&buttons[i], (uint8_t)(i / 32U), 1UL << (i % 32U), active_level, (uint8_t)i);
+        for (int ev = 0; ev < BTN_EVENT_COUNT; ev++) {
+            button_attach(&buttons[i], (ButtonEvent)ev, on_event, NULL);
+        }
+        button_start(&buttons[i]);
+    }
+
+    const uint8_t* frames = map + REPLAY_HEADER_SIZE;
+    double t0 = now_ns();
+    for (tick = 0; tick < ticks; tick++) {
+        frame = frames + (size_t)tick * words * 4U;
+        button_ticks();
+    }
+    double t1 = now_ns();
+
+    if (out && fclose(out) != 0) {
+        fprintf(stderr, "write error on %s\n", argv[2]);
+        return 1;
+    }
+    fprintf(stderr, "%u buttons, %u ticks, %lu events, %.1f ns/tick, %.2f ns/button/tick\n",
+            count, ticks, events, ticks ? (t1 - t0) / ticks : 0.0,
+            ticks ? (t1 - t0) / ticks / count : 0.0);
+    munmap((void*)map, (size_t)st.st_size);
+    return 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * MultiButton Trace Decoder
+ * Turns a dump of button_trace_dump() records (32-bit little-endian words,
+ * oldest first) into a readable timeline.
+ * Usage: trace_decode [-i interval_ms] [-b button_id] dump.bin
+ */
+
+#include "multi_button.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const state_names[8] = {
+    "IDLE", "PRESS", "RELEASE", "REPEAT", "LONG_HOLD", "?5", "?6", "?7"
+};
+
+static const char* const event_names[8] = {
+    "PRESS_DOWN", "PRESS_UP", "PRESS_REPEAT", "SINGLE_CLICK",
+    "DOUBLE_CLICK", "LONG_PRESS_START", "LONG_PRESS_HOLD", "-"
+};
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: trace_decode [-i interval_ms] [-b button_id] dump.bin\n");
+    exit(2);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned interval = TICKS_INTERVAL;
+    int filter = -1;
+    const char* path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-i") && i + 1 < argc) {
+            interval = (unsigned)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-b") && i + 1 < argc) {
+            filter = atoi(argv[++i]);
+        } else if (argv[i][0] == '-' || path) {
+            usage();
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) usage();
+
+    FILE* in = fopen(path, "rb");
+    if (!in) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+
+    // Ticks are 15-bit and wrap: unwrap relative to the first record
+    unsigned char word[4];
+    unsigned long tick = 0;
+    uint16_t last = 0;
+    int first = 1;
+    unsigned long records = 0;
+
+    printf("%10s  %8s  %3s  %-22s  %s\n", "time_ms", "tick", "id", "transition", "event");
+    while (fread(word, 1, sizeof(word), in) == sizeof(word)) {
+        uint32_t rec = (uint32_t)word[0] | (uint32_t)word[1] << 8 |
+                       (uint32_t)word[2] << 16 | (uint32_t)word[3] << 24;
+        uint16_t t = BUTTON_TRACE_TICK(rec);
+
+        if (!first) {
+            tick += (uint16_t)(t - last) & 0x7FFFU;
+        }
+        first = 0;
+        last = t;
+        records++;
+
+        if (filter >= 0 && BUTTON_TRACE_ID(rec) != filter) continue;
+
+        char transition[32];
+        uint8_t old_state = BUTTON_TRACE_OLD_STATE(rec);
+        uint8_t new_state = BUTTON_TRACE_NEW_STATE(rec);
+        if (old_state == new_state) {
+            snprintf(transition, sizeof(transition), "%s", state_names[old_state]);
+        } else {
+            snprintf(transition, sizeof(transition), "%s -> %s", state_names[old_state], state_names[new_state]);
+        }
+        printf("%10lu  %8lu  %3u  %-22s  %s\n", tick * interval, tick, BUTTON_TRACE_ID(rec),
+               transition, event_names[BUTTON_TRACE_EVENT(rec)]);
+    }
+    fclose(in);
+
+    if (!records) {
+        fprintf(stderr, "no records in %s\n", path);
+        return 1;
+    }
+    return 0;
+}